@@ -2,13 +2,141 @@
 # Use of this source code is governed by a BSD-style license that can be
 # found in the LICENSE file.
 
+_VERSION_SCRIPT = Label("//bazel:node_binding.lds")
+
+def _optimization_opts(mode):
+    """Returns copts and linkopts of |mode| but "pgo"."""
+    if mode == "lto":
+        return (
+            select({
+                "@node_binding//:windows": ["/GL"],
+                "//conditions:default": ["-flto"],
+            }),
+            select({
+                "@node_binding//:windows": ["/LTCG"],
+                "//conditions:default": ["-flto"],
+            }),
+        )
+    return ([], [])
+
+def _visibility_opts():
+    """Returns copts and linkopts exporting only the module initializer."""
+    return (
+        select({
+            "@node_binding//:windows": [],
+            "//conditions:default": [
+                "-fvisibility=hidden",
+                "-fvisibility-inlines-hidden",
+            ],
+        }),
+        select({
+            "@node_binding//:windows": [],
+            "@bazel_tools//src/conditions:darwin": [
+                "-Wl,-exported_symbol,_napi_register_module_v*",
+                "-Wl,-exported_symbol,_node_api_module_get_api_version_v*",
+            ],
+            "//conditions:default": [
+                "-Wl,--version-script,$(location %s)" % _VERSION_SCRIPT,
+            ],
+        }),
+    )
+
 def node_binding(
         name,
         srcs,
+        mode = "default",
+        pgo_training = None,
+        pgo_training_data = [],
+        copts = [],
+        linkopts = [],
         **kwargs):
+    """Builds a node addon, name.node.
+
+    Symbols are hidden but the module initializer, so that the addon exports
+    nothing else, and calls within it can be inlined and bound directly.
+
+    Args:
+        name: The addon is name.node.
+        srcs: Sources of the addon.
+        mode: How the addon is optimized, which is one of
+            "default": As copts say.
+            "lto": With link time optimization, which inlines across
+                translation units. Deps are optimized only if they are
+                built with node_binding_copts(lto = True).
+            "pgo": With profile guided optimization, which needs clang and
+                llvm-profdata. It builds the addon instrumented, runs
+                |pgo_training| with node and builds the addon again with the
+                profile, all in one build. Only |srcs| are optimized, so
+                put bindings of hot paths in them.
+        pgo_training: A JS script exercising the addon, whose path is given
+            as process.argv[2].
+        pgo_training_data: Files |pgo_training| reads.
+        copts: Passed to cc_binary.
+        linkopts: Passed to cc_binary.
+        **kwargs: Passed to cc_binary.
+    """
+    if mode not in ["default", "lto", "pgo"]:
+        fail("Unknown mode: " + mode, "mode")
+    if mode == "pgo" and not pgo_training:
+        fail("The pgo mode needs pgo_training.", "pgo_training")
+
+    visibility_copts, visibility_linkopts = _visibility_opts()
+    optimization_copts, optimization_linkopts = _optimization_opts(mode)
+    kwargs["additional_linker_inputs"] = (
+        kwargs.get("additional_linker_inputs", []) + [_VERSION_SCRIPT]
+    )
+
+    if mode == "pgo":
+        native.cc_binary(
+            name = name + "_instrumented.so",
+            srcs = srcs,
+            copts = copts + visibility_copts + ["-fprofile-instr-generate"],
+            linkopts = linkopts + visibility_linkopts +
+                       ["-fprofile-instr-generate"],
+            linkshared = 1,
+            visibility = ["//visibility:private"],
+            **kwargs
+        )
+
+        # Runs the training in a temporary directory, since the addon must be
+        # named *.node to be required. The profile is named *.inc, so that
+        # it can be a src of the addon, which makes it an input of compile
+        # actions, since additional_compiler_inputs needs Bazel 7.
+        native.genrule(
+            name = name + "_profile",
+            srcs = [
+                ":" + name + "_instrumented.so",
+                pgo_training,
+            ] + pgo_training_data,
+            outs = [name + "_profdata.inc"],
+            cmd = " && ".join([
+                "TRAINING_DIR=$$(mktemp -d)",
+                "cp -f $(location :%s_instrumented.so) " % name +
+                "$$TRAINING_DIR/%s.node" % name,
+                "LLVM_PROFILE_FILE=$$TRAINING_DIR/%p.profraw " +
+                "node $(location %s) $$TRAINING_DIR/%s.node" % (
+                    pgo_training,
+                    name,
+                ),
+                "llvm-profdata merge -output=$@ $$TRAINING_DIR/*.profraw",
+                "rm -rf $$TRAINING_DIR",
+            ]),
+            tags = kwargs.get("tags", []),
+            visibility = ["//visibility:private"],
+        )
+
+        srcs = srcs + [":" + name + "_profile"]
+        optimization_copts = [
+            "-fprofile-instr-use=$(location :%s_profile)" % name,
+            "-Wno-profile-instr-unprofiled",
+            "-Wno-profile-instr-out-of-date",
+        ]
+
     native.cc_binary(
         name = name + ".so",
         srcs = srcs,
+        copts = copts + visibility_copts + optimization_copts,
+        linkopts = linkopts + visibility_linkopts + optimization_linkopts,
         linkshared = 1,
         **kwargs
     )
@@ -18,5 +146,6 @@ def node_binding(
         srcs = [":" + name + ".so"],
         outs = [name + ".node"],
         cmd = "cp -f $< $@",
+        tags = kwargs.get("tags", []),
         visibility = ["//visibility:private"],
     )
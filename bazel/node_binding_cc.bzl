@@ -1,4 +1,30 @@
-def node_binding_copts():
+def node_binding_copts(cxx20 = False, lto = False):
+    """Returns copts for node_binding.
+
+    Args:
+        cxx20: Builds with C++20 instead of C++14, which coroutine.h needs.
+        lto: Builds for link time optimization, for deps of a node_binding
+            whose mode is "lto".
+    """
+    lto_copts = []
+    if lto:
+        lto_copts = select({
+            "@node_binding//:windows": [
+                "/GL",
+            ],
+            "//conditions:default": [
+                "-flto",
+            ],
+        })
+    if cxx20:
+        return select({
+            "@node_binding//:windows": [
+                "/std:c++20",
+            ],
+            "//conditions:default": [
+                "-std=c++20",
+            ],
+        }) + lto_copts
     return select({
         "@node_binding//:windows": [
             "/std:c++14",
@@ -6,4 +32,4 @@ def node_binding_copts():
         "//conditions:default": [
             "-std=c++14",
         ],
-    })
\ No newline at end of file
+    }) + lto_copts
@@ -0,0 +1,70 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "node_binding/class.h"
+#include "node_binding/constructor.h"
+#include "node_binding/typed_call.h"
+
+struct Point {
+  int x;
+  int y;
+
+  Point(int x = 0, int y = 0) : x(x), y(y) {}
+
+  int Dot(const int scale) const { return (x + y) * scale; }
+};
+
+// Hand-written binding, as in examples/point_js.cc.
+class PointJs : public Napi::ObjectWrap<PointJs> {
+ public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  PointJs(const Napi::CallbackInfo& info);
+
+  void SetX(const Napi::CallbackInfo& info, const Napi::Value& v) {
+    point_.x = node_binding::ToNativeValue<int>(v);
+  }
+
+  Napi::Value GetX(const Napi::CallbackInfo& info) {
+    return node_binding::ToJSValue(info, point_.x);
+  }
+
+  Napi::Value Dot(const Napi::CallbackInfo& info) {
+    return node_binding::TypedCall(info, &Point::Dot, &point_);
+  }
+
+ private:
+  Point point_;
+};
+
+// static
+void PointJs::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env, "HandWrittenPoint",
+                  {
+                      InstanceAccessor("x", &PointJs::GetX, &PointJs::SetX),
+                      InstanceMethod("dot", &PointJs::Dot),
+                  });
+
+  exports.Set("HandWrittenPoint", func);
+}
+
+PointJs::PointJs(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<PointJs>(info) {
+  point_ = node_binding::TypedConstruct(
+      info, &node_binding::Constructor<Point>::Call<int, int>);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  PointJs::Init(env, exports);
+  exports.Set("GeneratedPoint",
+              node_binding::Class<Point>("GeneratedPoint")
+                  .Constructor<int, int>()
+                  .Field("x", NODE_BINDING_MEMBER(&Point::x))
+                  .Method("dot", NODE_BINDING_MEMBER(&Point::Dot))
+                  .Define(env));
+
+  return exports;
+}
+
+NODE_API_MODULE(0_class_binding, Init)
\ No newline at end of file
@@ -0,0 +1,31 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares the hand-written ObjectWrap binding with the one generated by
+// node_binding::Class<T>.
+
+const {compare} = require('../common');
+const binding = require('./build/Release/0_class_binding.node');
+
+const handWritten = new binding.HandWrittenPoint(1, 2);
+const generated = new binding.GeneratedPoint(1, 2);
+
+let sink = 0;
+
+compare('get x', {
+  'hand-written': () => sink += handWritten.x,
+  'Class<T>': () => sink += generated.x,
+});
+
+compare('set x', {
+  'hand-written': (i) => handWritten.x = i & 0xff,
+  'Class<T>': (i) => generated.x = i & 0xff,
+});
+
+compare('dot(scale)', {
+  'hand-written': () => sink += handWritten.dot(2),
+  'Class<T>': () => sink += generated.dot(2),
+});
+
+module.exports = sink;
\ No newline at end of file
@@ -0,0 +1,45 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "node_binding/raw_call.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::NewRawFunction;
+
+int CAdd(int a, int b) { return a + b; }
+
+int CSum8(int a, int b, int c, int d, int e, int f, int g, int h) {
+  return a + b + c + d + e + f + g + h;
+}
+
+size_t CLength(const std::string& s) { return s.length(); }
+
+Napi::Value TypedAdd(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CAdd);
+}
+
+Napi::Value TypedSum8(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CSum8);
+}
+
+Napi::Value TypedLength(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CLength);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("typedAdd", Napi::Function::New(env, TypedAdd));
+  exports.Set("typedSum8", Napi::Function::New(env, TypedSum8));
+  exports.Set("typedLength", Napi::Function::New(env, TypedLength));
+  exports.Set("rawAdd",
+              NewRawFunction(env, "rawAdd", NODE_BINDING_MEMBER(&CAdd)));
+  exports.Set("rawSum8",
+              NewRawFunction(env, "rawSum8", NODE_BINDING_MEMBER(&CSum8)));
+  exports.Set("rawLength", NewRawFunction(env, "rawLength",
+                                          NODE_BINDING_MEMBER(&CLength)));
+  return exports;
+}
+
+NODE_API_MODULE(1_raw_call, Init)
\ No newline at end of file
@@ -0,0 +1,29 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares TypedCall(), which goes through Napi::CallbackInfo, with
+// RawCall(), which converts straight from napi_value.
+
+const {compare} = require('../common');
+const binding = require('./build/Release/1_raw_call.node');
+
+let sink = 0;
+
+compare('add(a, b)', {
+  'TypedCall': (i) => sink += binding.typedAdd(i, 1),
+  'RawCall': (i) => sink += binding.rawAdd(i, 1),
+});
+
+// More arguments than Napi::CallbackInfo keeps on the stack.
+compare('sum8(a, ..., h)', {
+  'TypedCall': (i) => sink += binding.typedSum8(i, 1, 2, 3, 4, 5, 6, 7),
+  'RawCall': (i) => sink += binding.rawSum8(i, 1, 2, 3, 4, 5, 6, 7),
+});
+
+compare('length(string)', {
+  'TypedCall': () => sink += binding.typedLength('node_binding'),
+  'RawCall': () => sink += binding.rawLength('node_binding'),
+});
+
+module.exports = sink;
\ No newline at end of file
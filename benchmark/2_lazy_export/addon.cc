@@ -0,0 +1,82 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// An addon binding kNumClasses synthetic classes. It is built twice, with
+// and without LAZY_EXPORT defined.
+
+#include <string>
+#include <utility>
+
+#include "node_binding/class.h"
+#include "node_binding/lazy_export.h"
+
+using node_binding::Class;
+using node_binding::LazyExport;
+
+constexpr size_t kNumClasses = 500;
+
+template <size_t N>
+struct Synthetic {
+  int x = 0;
+  int y = 0;
+
+  Synthetic() = default;
+  Synthetic(int x, int y) : x(x), y(y) {}
+
+  int Sum() const { return x + y + N; }
+  void Scale(int factor) {
+    x *= factor;
+    y *= factor;
+  }
+};
+
+template <size_t N>
+const char* ClassName() {
+  static const std::string name = "Synthetic" + std::to_string(N);
+  return name.c_str();
+}
+
+template <size_t N>
+Napi::Value DefineSynthetic(Napi::Env env) {
+  using T = Synthetic<N>;
+  return Class<T>(ClassName<N>())
+      .template Constructor<>()
+      .template Constructor<int, int>()
+      .Field("x", NODE_BINDING_MEMBER(&T::x))
+      .Field("y", NODE_BINDING_MEMBER(&T::y))
+      .Method("sum", NODE_BINDING_MEMBER(&T::Sum))
+      .Method("scale", NODE_BINDING_MEMBER(&T::Scale))
+      .Define(env);
+}
+
+#if defined(LAZY_EXPORT)
+
+template <size_t N>
+void ExportSynthetic(Napi::Env env, Napi::Object exports) {
+  static LazyExport lazy_export(ClassName<N>(), &DefineSynthetic<N>);
+  lazy_export.Export(exports);
+}
+
+#else
+
+template <size_t N>
+void ExportSynthetic(Napi::Env env, Napi::Object exports) {
+  exports.Set(ClassName<N>(), DefineSynthetic<N>(env));
+}
+
+#endif
+
+template <size_t... Indices>
+void ExportAll(Napi::Env env, Napi::Object exports,
+               std::index_sequence<Indices...>) {
+  int dummy[] = {(ExportSynthetic<Indices>(env, exports), 0)...};
+  (void)dummy;
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  ExportAll(env, exports, std::make_index_sequence<kNumClasses>());
+  return exports;
+}
+
+NODE_API_MODULE(NODE_GYP_MODULE_NAME, Init)
\ No newline at end of file
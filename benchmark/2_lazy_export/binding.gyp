@@ -0,0 +1,20 @@
+{
+  "target_defaults": {
+    "cflags!": ["-fno-exceptions"],
+    "cflags_cc!": ["-fno-exceptions"],
+    "sources": ["addon.cc"],
+    "include_dirs": [
+      "<!@(node -p \"require('../../').include\")",
+    ],
+    'defines': ['NAPI_DISABLE_CPP_EXCEPTIONS'],
+  },
+  "targets": [
+    {
+      "target_name": "2_lazy_export_eager",
+    },
+    {
+      "target_name": "2_lazy_export_lazy",
+      'defines': ['LAZY_EXPORT'],
+    }
+  ]
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares the startup time of an addon binding 500 classes eagerly with the
+// one binding them with node_binding::LazyExport. An addon can be loaded
+// only once per process, so every sample runs in a fresh process.
+
+const {execFileSync} = require('child_process');
+
+const SAMPLES = 20;
+
+const MODES = ['eager', 'lazy'];
+
+// Runs in a child process and prints the elapsed ns of each step.
+function child(mode) {
+  const start = process.hrtime.bigint();
+  const binding = require(`./build/Release/2_lazy_export_${mode}.node`);
+  const loaded = process.hrtime.bigint();
+  new binding.Synthetic0(1, 2).sum();
+  const first = process.hrtime.bigint();
+  for (const name of Object.keys(binding)) {
+    new binding[name](1, 2).sum();
+  }
+  const all = process.hrtime.bigint();
+  console.log(JSON.stringify([loaded - start, first - loaded, all - first]
+                                 .map(Number)));
+}
+
+function main() {
+  const steps = ['require()', 'first class', 'rest of classes'];
+  const best = {};
+  for (const mode of MODES) best[mode] = steps.map(() => Infinity);
+
+  for (let i = 0; i < SAMPLES; ++i) {
+    for (const mode of MODES) {
+      const out = execFileSync(process.execPath, [__filename, mode]);
+      JSON.parse(out).forEach((ns, j) => {
+        best[mode][j] = Math.min(best[mode][j], ns);
+      });
+    }
+  }
+
+  console.log('startup of 500 classes');
+  steps.forEach((step, j) => {
+    console.log(`  ${step}`);
+    for (const mode of MODES) {
+      const us = best[mode][j] / 1e3;
+      console.log(`    ${mode.padEnd(22)} ${us.toFixed(1).padStart(8)} us`);
+    }
+  });
+}
+
+if (process.argv[2]) {
+  child(process.argv[2]);
+} else {
+  main();
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "node_binding/function.h"
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::FunctionRef;
+
+template <typename Less>
+int SortAndSum(std::vector<int> values, Less less) {
+  std::sort(values.begin(), values.end(), less);
+  return values.front() - values.back();
+}
+
+// Hand-written, calling Napi::Function in a handle scope per comparison.
+Napi::Value HandWrittenSort(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::vector<int> values =
+      node_binding::ToNativeValue<std::vector<int>>(info[0]);
+  Napi::Function less = info[1].As<Napi::Function>();
+  int ret = SortAndSum(values, [env, &less](int a, int b) {
+    Napi::HandleScope scope(env);
+    return less.Call({Napi::Number::New(env, a), Napi::Number::New(env, b)})
+        .As<Napi::Boolean>()
+        .Value();
+  });
+  return Napi::Number::New(env, ret);
+}
+
+int StdFunctionSort(std::vector<int> values,
+                    std::function<bool(int, int)> less) {
+  return SortAndSum(std::move(values), less);
+}
+
+int FunctionRefSort(std::vector<int> values, FunctionRef<bool(int, int)> less) {
+  return SortAndSum(std::move(values), less);
+}
+
+Napi::Value StdFunctionSortJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &StdFunctionSort);
+}
+
+Napi::Value FunctionRefSortJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &FunctionRefSort);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("handWrittenSort", Napi::Function::New(env, HandWrittenSort));
+  exports.Set("stdFunctionSort", Napi::Function::New(env, StdFunctionSortJs));
+  exports.Set("functionRefSort", Napi::Function::New(env, FunctionRefSortJs));
+  return exports;
+}
+
+NODE_API_MODULE(3_function, Init)
\ No newline at end of file
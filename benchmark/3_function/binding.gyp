@@ -0,0 +1,14 @@
+{
+  "targets": [
+    {
+      "target_name": "3_function",
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "sources": ["addon.cc"],
+      "include_dirs": [
+        "<!@(node -p \"require('../../').include\")",
+      ],
+      'defines': ['NAPI_DISABLE_CPP_EXCEPTIONS'],
+    }
+  ]
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares native sorts calling a JS comparator through a hand-written
+// Napi::Function call, std::function and node_binding::FunctionRef.
+
+const {compare} = require('../common');
+const binding = require('./build/Release/3_function.node');
+
+const SIZE = 1000;
+const ITERATIONS = 200;
+
+const values = [];
+for (let i = 0; i < SIZE; ++i) values.push((i * 7919) % SIZE);
+const less = (a, b) => a < b;
+
+let sink = 0;
+
+compare(`sort(${SIZE} ints, less)`, {
+  'hand-written': () => sink += binding.handWrittenSort(values, less),
+  'std::function': () => sink += binding.stdFunctionSort(values, less),
+  'FunctionRef': () => sink += binding.functionRefSort(values, less),
+}, ITERATIONS);
+
+module.exports = sink;
\ No newline at end of file
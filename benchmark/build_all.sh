@@ -0,0 +1,8 @@
+#!/usr/bin/env bash
+
+set -e
+
+node-gyp rebuild -C benchmark/0_class_binding
+node-gyp rebuild -C benchmark/1_raw_call
+node-gyp rebuild -C benchmark/2_lazy_export
+node-gyp rebuild -C benchmark/3_function
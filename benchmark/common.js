@@ -0,0 +1,50 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+const DEFAULT_ITERATIONS = 1e6;
+const WARMUP_ITERATIONS = 1e5;
+const ROUNDS = 5;
+// Under test/profile/run.sh, calls are counted rather than timed, and each
+// thread keeps only its latest spans, so a few calls are made.
+const PROFILING_ITERATIONS = 1e3;
+const PROFILING = !!process.env.NODE_BINDING_PROFILE;
+
+// Runs |fn| |iterations| times after warming up and returns ns per call.
+function measure(fn, iterations = DEFAULT_ITERATIONS) {
+  if (PROFILING) iterations = Math.min(iterations, PROFILING_ITERATIONS);
+  const warmup = Math.min(WARMUP_ITERATIONS, iterations / 10);
+  for (let i = 0; i < warmup; ++i) fn(i);
+
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; ++i) fn(i);
+  const end = process.hrtime.bigint();
+
+  return Number(end - start) / iterations;
+}
+
+// Measures every case of |cases| in turns and prints the best ns per call of
+// each, relative to the first one.
+function compare(title, cases, iterations = DEFAULT_ITERATIONS) {
+  console.log(title);
+  const entries = Object.entries(cases);
+  const best = entries.map(() => Infinity);
+  for (let round = 0; round < (PROFILING ? 1 : ROUNDS); ++round) {
+    entries.forEach(([name, fn], i) => {
+      best[i] = Math.min(best[i], measure(fn, iterations));
+    });
+  }
+
+  const baseline = best[0];
+  entries.forEach(([name], i) => {
+    const ns = best[i];
+    const ratio = (ns / baseline).toFixed(2);
+    console.log(`  ${name.padEnd(24)} ${ns.toFixed(1).padStart(8)} ns/call` +
+                `  x${ratio}`);
+  });
+}
+
+module.exports = {
+  measure,
+  compare,
+};
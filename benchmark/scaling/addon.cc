@@ -0,0 +1,53 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "examples/calculator_js.h"
+#include "examples/point_js.h"
+#include "examples/rect_js.h"
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+
+int CSum(const std::vector<int>& values) {
+  int sum = 0;
+  for (int value : values) sum += value;
+  return sum;
+}
+
+std::vector<int> CRange(int n) {
+  std::vector<int> values(n);
+  for (int i = 0; i < n; ++i) values[i] = i;
+  return values;
+}
+
+std::string CJoin(const std::string& a, const std::string& b) {
+  return a + "/" + b;
+}
+
+Napi::Value Sum(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CSum);
+}
+
+Napi::Value Range(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CRange);
+}
+
+Napi::Value Join(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CJoin);
+}
+
+// The example classes, and convertors which they don't use.
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  CalculatorJs::Init(env, exports);
+  PointJs::Init(env, exports);
+  RectJs::Init(env, exports);
+  exports.Set("sum", Napi::Function::New(env, Sum));
+  exports.Set("range", Napi::Function::New(env, Range));
+  exports.Set("join", Napi::Function::New(env, Join));
+  return exports;
+}
+
+NODE_API_MODULE(scaling, Init)
@@ -0,0 +1,30 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Bindings which the harness calls. Each case takes the addon and returns a
+// function making one call, which is given the index of the call.
+
+const SHORT_VECTOR = Array.from({length: 16}, (_, i) => i);
+
+let sink = 0;
+
+module.exports = {
+  'TypedCall': (binding) => (i) => sink += binding.Calculator.add(i, 1),
+  'TypedConstruct': (binding) => (i) => new binding.Point(i, 1),
+  'vector in': (binding) => () => sink += binding.sum(SHORT_VECTOR),
+  'vector out': (binding) => () => sink += binding.range(16).length,
+  'string': (binding) => () => sink += binding.join('node', 'binding').length,
+  'Point': (binding) => {
+    const point = new binding.Point(1, 2);
+    return (i) => {
+      point.x = i & 0xff;
+      sink += point.x + point.y;
+    };
+  },
+  'Rect': (binding) => {
+    const rect = new binding.Rect(new binding.Point(0, 4),
+                                  new binding.Point(4, 0));
+    return () => sink += rect.area() + rect.topLeft.x;
+  },
+};
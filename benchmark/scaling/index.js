@@ -0,0 +1,212 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how bindings scale with the number of worker threads, or
+// processes, each of which loads the addon and calls bindings in a loop.
+// For each case and number of workers, it prints the total throughput, the
+// throughput per worker relative to the fewest workers, and the latency of
+// calls.
+//
+//   bazel run -c opt //benchmark/scaling -- [--workers=1,2,4]
+//       [--mode=threads|processes] [--duration=<ms>] [--cases=Point,Rect]
+//
+// Latency is measured per batch of calls, since a call takes about as long
+// as reading the clock, so tails of single calls are averaged out.
+
+const {fork} = require('child_process');
+const os = require('os');
+const path = require('path');
+const {Worker, isMainThread, parentPort, workerData} =
+    require('worker_threads');
+
+const cases = require('./cases');
+
+const BATCH = 64;
+const WARMUP_CALLS = 1e5;
+const BUCKET_RATIO = 1.05;
+const NUM_BUCKETS = 512;
+
+// A histogram of latencies in ns, whose buckets grow by BUCKET_RATIO, so
+// that histograms of workers are merged by adding them.
+class Histogram {
+  constructor(buckets = new Array(NUM_BUCKETS).fill(0)) {
+    this.buckets = buckets;
+  }
+
+  add(ns) {
+    const i = Math.floor(Math.log(Math.max(ns, 1)) / Math.log(BUCKET_RATIO));
+    ++this.buckets[Math.min(i, NUM_BUCKETS - 1)];
+  }
+
+  merge(other) {
+    other.buckets.forEach((count, i) => this.buckets[i] += count);
+  }
+
+  // Returns the upper bound of the |p|th quantile.
+  quantile(p) {
+    const total = this.buckets.reduce((sum, count) => sum + count, 0);
+    let seen = 0;
+    for (let i = 0; i < NUM_BUCKETS; ++i) {
+      seen += this.buckets[i];
+      if (seen >= total * p) return BUCKET_RATIO ** (i + 1);
+    }
+    return Infinity;
+  }
+}
+
+function parseArgs(argv) {
+  const cpus = os.cpus().length;
+  const workers = [];
+  for (let n = 1; n < cpus; n *= 2) workers.push(n);
+  workers.push(cpus);
+
+  const args = {
+    addon: path.join(__dirname, '../../bazel-bin/benchmark/scaling/addon.node'),
+    workers,
+    mode: 'threads',
+    duration: 1000,
+    cases: Object.keys(cases),
+  };
+  for (const arg of argv) {
+    const [, key, value] = /^--([^=]+)=(.*)$/.exec(arg) || [];
+    if (key === 'workers') {
+      args.workers = value.split(',').map(Number);
+    } else if (key === 'cases') {
+      args.cases = value.split(',');
+    } else if (key === 'duration') {
+      args.duration = Number(value);
+    } else if (key in args) {
+      args[key] = value;
+    } else {
+      throw new Error(`Unknown argument: ${arg}`);
+    }
+  }
+  if (!['threads', 'processes'].includes(args.mode)) {
+    throw new Error(`Unknown mode: ${args.mode}`);
+  }
+  for (const name of args.cases) {
+    if (!(name in cases)) throw new Error(`Unknown case: ${name}`);
+  }
+  args.addon = path.resolve(args.addon);
+  return args;
+}
+
+// Runs in a worker thread or a child process, and makes calls of a case
+// when told to.
+function runWorker(addon, send, receive) {
+  const binding = require(addon);
+  let call;
+
+  receive(({type, name, duration}) => {
+    if (type == 'prepare') {
+      call = cases[name](binding);
+      for (let i = 0; i < WARMUP_CALLS; ++i) call(i);
+      send({type: 'ready'});
+    } else if (type == 'start') {
+      const histogram = new Histogram();
+      const start = process.hrtime.bigint();
+      const end = start + BigInt(duration * 1e6);
+      let calls = 0;
+      let now = start;
+      while (now < end) {
+        for (let i = 0; i < BATCH; ++i) call(calls + i);
+        const next = process.hrtime.bigint();
+        histogram.add(Number(next - now) / BATCH);
+        calls += BATCH;
+        now = next;
+      }
+      const seconds = Number(now - start) / 1e9;
+      send({type: 'result', throughput: calls / seconds,
+            buckets: histogram.buckets});
+    }
+  });
+}
+
+function spawnWorker(mode, addon) {
+  if (mode == 'threads') {
+    const worker = new Worker(__filename, {workerData: {addon}});
+    return {
+      send: (message) => worker.postMessage(message),
+      receive: (listener) => worker.on('message', listener),
+      close: () => worker.terminate(),
+    };
+  }
+  const child = fork(__filename, ['--worker', addon]);
+  return {
+    send: (message) => child.send(message),
+    receive: (listener) => child.on('message', listener),
+    close: () => child.kill(),
+  };
+}
+
+// Sends |message| to all |workers| and resolves to their replies.
+function broadcast(workers, message) {
+  return Promise.all(workers.map((worker) => new Promise((resolve) => {
+    worker.pending = resolve;
+    worker.send(message);
+  })));
+}
+
+async function measure(args, n) {
+  const workers = [...Array(n)].map(() => spawnWorker(args.mode, args.addon));
+  for (const worker of workers) {
+    worker.receive((message) => worker.pending(message));
+  }
+
+  const results = {};
+  for (const name of args.cases) {
+    await broadcast(workers, {type: 'prepare', name});
+    const replies =
+        await broadcast(workers, {type: 'start', duration: args.duration});
+    const histogram = new Histogram();
+    let throughput = 0;
+    for (const reply of replies) {
+      throughput += reply.throughput;
+      histogram.merge(new Histogram(reply.buckets));
+    }
+    results[name] = {throughput, histogram};
+  }
+  await Promise.all(workers.map((worker) => worker.close()));
+  return results;
+}
+
+async function main() {
+  const args = parseArgs(process.argv.slice(2));
+  console.log(`${os.cpus().length} cpus, ${args.mode}, ` +
+              `${args.duration} ms per run`);
+
+  const runs = [];
+  for (const n of args.workers) runs.push([n, await measure(args, n)]);
+
+  for (const name of args.cases) {
+    console.log(name);
+    console.log('  workers  Mcalls/s  per worker' +
+                ['p50', 'p99', 'p99.9'].map((p) => p.padStart(11)).join(''));
+    const [baseN, baseResults] = runs[0];
+    const base = baseResults[name].throughput / baseN;
+    for (const [n, results] of runs) {
+      const {throughput, histogram} = results[name];
+      const efficiency = throughput / n / base;
+      const latency = [0.5, 0.99, 0.999].map(
+          (p) => `${histogram.quantile(p).toFixed(0)} ns`.padStart(11));
+      console.log(`  ${String(n).padStart(7)}` +
+                  `  ${(throughput / 1e6).toFixed(2).padStart(8)}` +
+                  `  ${(efficiency * 100).toFixed(0).padStart(9)}%` +
+                  latency.join(''));
+    }
+  }
+}
+
+if (!isMainThread) {
+  runWorker(workerData.addon, (message) => parentPort.postMessage(message),
+            (listener) => parentPort.on('message', listener));
+} else if (process.argv[2] == '--worker') {
+  runWorker(process.argv[3], (message) => process.send(message),
+            (listener) => process.on('message', listener));
+} else {
+  main().catch((error) => {
+    console.error(error);
+    process.exitCode = 1;
+  });
+}
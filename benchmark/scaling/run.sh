@@ -0,0 +1,6 @@
+#!/usr/bin/env bash
+
+# Runs the harness with node from PATH, from the runfiles of the target.
+# Arguments are passed to benchmark/scaling/index.js.
+
+exec node benchmark/scaling/index.js "$@"
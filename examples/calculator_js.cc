@@ -9,25 +9,24 @@
 
 using namespace node_binding;
 
-Napi::FunctionReference CalculatorJs::constructor_;
+LazyExport CalculatorJs::class_("Calculator", &CalculatorJs::Define);
 
 // static
 void CalculatorJs::Init(Napi::Env env, Napi::Object exports) {
-  Napi::Function func =
-      DefineClass(env, "Calculator",
-                  {
-                      StaticMethod("add", &CalculatorJs::Add),
-                      StaticMethod("sub", &CalculatorJs::Sub),
-                      InstanceMethod("result", &CalculatorJs::result),
-                      InstanceMethod("increment", &CalculatorJs::Increment),
-                      InstanceMethod("decrement", &CalculatorJs::Decrement),
-                      InstanceMethod("clear", &CalculatorJs::Clear),
-                  });
-
-  constructor_ = Napi::Persistent(func);
-  constructor_.SuppressDestruct();
+  class_.Export(exports);
+}
 
-  exports.Set("Calculator", func);
+// static
+Napi::Value CalculatorJs::Define(Napi::Env env) {
+  return DefineClass(env, "Calculator",
+                     {
+                         StaticMethod("add", &CalculatorJs::Add),
+                         StaticMethod("sub", &CalculatorJs::Sub),
+                         InstanceMethod("result", &CalculatorJs::result),
+                         InstanceMethod("increment", &CalculatorJs::Increment),
+                         InstanceMethod("decrement", &CalculatorJs::Decrement),
+                         InstanceMethod("clear", &CalculatorJs::Clear),
+                     });
 }
 
 CalculatorJs::CalculatorJs(const Napi::CallbackInfo& info)
@@ -8,10 +8,12 @@
 
 #include "examples/calculator.h"
 #include "napi.h"
+#include "node_binding/lazy_export.h"
 
 class CalculatorJs : public Napi::ObjectWrap<CalculatorJs> {
  public:
   static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Value Define(Napi::Env env);
   CalculatorJs(const Napi::CallbackInfo& info);
 
   static Napi::Value Add(const Napi::CallbackInfo& info);
@@ -23,7 +25,7 @@ class CalculatorJs : public Napi::ObjectWrap<CalculatorJs> {
   void Clear(const Napi::CallbackInfo& info);
 
  private:
-  static Napi::FunctionReference constructor_;
+  static node_binding::LazyExport class_;
 
   std::unique_ptr<Calculator> calculator_;
 };
@@ -0,0 +1,19 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Trains binding_pgo, whose instrumented addon is given as process.argv[2].
+const binding = require(process.argv[2]);
+
+for (let i = 0; i < 100000; ++i) {
+  binding.Calculator.add(i, 1);
+  const c = new binding.Calculator(i);
+  c.increment();
+  c.decrement(2);
+  c.result();
+
+  const rect = new binding.Rect(new binding.Point(0, i),
+                                new binding.Point(i, 0));
+  rect.topLeft.x = 1;
+  rect.area();
+}
@@ -9,28 +9,27 @@
 
 using namespace node_binding;
 
-Napi::FunctionReference PointJs::constructor_;
+LazyExport PointJs::class_("Point", &PointJs::Define);
 
 // static
 void PointJs::Init(Napi::Env env, Napi::Object exports) {
-  Napi::Function func =
-      DefineClass(env, "Point",
-                  {
-                      InstanceAccessor("x", &PointJs::GetX, &PointJs::SetX),
-                      InstanceAccessor("y", &PointJs::GetY, &PointJs::SetY),
-                  });
-
-  constructor_ = Napi::Persistent(func);
-  constructor_.SuppressDestruct();
+  class_.Export(exports);
+}
 
-  exports.Set("Point", func);
+// static
+Napi::Value PointJs::Define(Napi::Env env) {
+  return DefineClass(env, "Point",
+                     {
+                         InstanceAccessor("x", &PointJs::GetX, &PointJs::SetX),
+                         InstanceAccessor("y", &PointJs::GetY, &PointJs::SetY),
+                     });
 }
 
 // static
 Napi::Object PointJs::New(Napi::Env env, const Point& p) {
   Napi::EscapableHandleScope scope(env);
 
-  Napi::Object object = constructor_.New({
+  Napi::Object object = class_.Get(env).As<Napi::Function>().New({
       Napi::Number::New(env, p.x),
       Napi::Number::New(env, p.y),
   });
@@ -38,9 +37,17 @@ Napi::Object PointJs::New(Napi::Env env, const Point& p) {
   return scope.Escape(napi_value(object)).ToObject();
 }
 
+// static
+Napi::Object PointJs::NewView(Napi::Object owner, Point* p) {
+  return NewMemberView(class_.Get(owner.Env()).As<Napi::Function>(), owner,
+                       p);
+}
+
 PointJs::PointJs(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<PointJs>(info) {
-  if (info.Length() == 0) {
+  if (IsMemberViewConstructCall(info)) {
+    point_.BindMemberView(info);
+  } else if (info.Length() == 0) {
     point_ = TypedConstruct(info, &Constructor<Point>::Call<int, int>, 0, 0);
   } else if (info.Length() == 1) {
     point_ = TypedConstruct(info, &Constructor<Point>::Call<int, int>, 0);
@@ -53,17 +60,17 @@ PointJs::PointJs(const Napi::CallbackInfo& info)
 }
 
 void PointJs::SetX(const Napi::CallbackInfo& info, const Napi::Value& v) {
-  point_.x = ToNativeValue<int>(v);
+  point_->x = ToNativeValue<int>(v);
 }
 
 void PointJs::SetY(const Napi::CallbackInfo& info, const Napi::Value& v) {
-  point_.y = ToNativeValue<int>(v);
+  point_->y = ToNativeValue<int>(v);
 }
 
 Napi::Value PointJs::GetX(const Napi::CallbackInfo& info) {
-  return ToJSValue(info, point_.x);
+  return ToJSValue(info, point_->x);
 }
 
 Napi::Value PointJs::GetY(const Napi::CallbackInfo& info) {
-  return ToJSValue(info, point_.y);
+  return ToJSValue(info, point_->y);
 }
@@ -6,13 +6,17 @@
 
 #include <iostream>
 
+#include "node_binding/lazy_export.h"
+#include "node_binding/member_view.h"
 #include "node_binding/type_convertor.h"
 #include "point.h"
 
 class PointJs : public Napi::ObjectWrap<PointJs> {
  public:
   static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Value Define(Napi::Env env);
   static Napi::Object New(Napi::Env env, const Point& p);
+  static Napi::Object NewView(Napi::Object owner, Point* p);
   PointJs(const Napi::CallbackInfo& info);
 
   void SetX(const Napi::CallbackInfo& info, const Napi::Value& v);
@@ -22,9 +26,9 @@ class PointJs : public Napi::ObjectWrap<PointJs> {
   Napi::Value GetY(const Napi::CallbackInfo& info);
 
  private:
-  static Napi::FunctionReference constructor_;
+  static node_binding::LazyExport class_;
 
-  Point point_;
+  node_binding::ViewableValue<Point> point_;
 };
 
 namespace node_binding {
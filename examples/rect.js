@@ -13,4 +13,7 @@ const bottomRight = new binding.Point(5, 1);
 const rect = new binding.Rect(topLeft, bottomRight);
 printPoint(rect.topLeft);
 printPoint(rect.bottomRight);
+console.log(rect.area());
+rect.topLeft.x = 2;
+printPoint(rect.topLeft);
 console.log(rect.area());
\ No newline at end of file
@@ -9,11 +9,16 @@
 
 using namespace node_binding;
 
-Napi::FunctionReference RectJs::constructor_;
+LazyExport RectJs::class_("Rect", &RectJs::Define);
 
 // static
 void RectJs::Init(Napi::Env env, Napi::Object exports) {
-  Napi::Function func = DefineClass(
+  class_.Export(exports);
+}
+
+// static
+Napi::Value RectJs::Define(Napi::Env env) {
+  return DefineClass(
       env, "Rect",
       {
           InstanceAccessor("topLeft", &RectJs::GetTopLeft, &RectJs::SetTopLeft),
@@ -21,11 +26,6 @@ void RectJs::Init(Napi::Env env, Napi::Object exports) {
                            &RectJs::SetBottomRight),
           InstanceMethod("area", &RectJs::Area),
       });
-
-  constructor_ = Napi::Persistent(func);
-  constructor_.SuppressDestruct();
-
-  exports.Set("Rect", func);
 }
 
 RectJs::RectJs(const Napi::CallbackInfo& info)
@@ -55,11 +55,13 @@ void RectJs::SetBottomRight(const Napi::CallbackInfo& info,
 }
 
 Napi::Value RectJs::GetTopLeft(const Napi::CallbackInfo& info) {
-  return ToJSValue(info, rect_.top_left);
+  return top_left_view_.Get(
+      [this]() { return PointJs::NewView(Value(), &rect_.top_left); });
 }
 
 Napi::Value RectJs::GetBottomRight(const Napi::CallbackInfo& info) {
-  return ToJSValue(info, rect_.bottom_right);
+  return bottom_right_view_.Get(
+      [this]() { return PointJs::NewView(Value(), &rect_.bottom_right); });
 }
 
 Napi::Value RectJs::Area(const Napi::CallbackInfo& info) {
@@ -7,10 +7,13 @@
 #include "examples/point_js.h"
 #include "examples/rect.h"
 #include "napi.h"
+#include "node_binding/lazy_export.h"
+#include "node_binding/member_view.h"
 
 class RectJs : public Napi::ObjectWrap<RectJs> {
  public:
   static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Value Define(Napi::Env env);
   RectJs(const Napi::CallbackInfo& info);
 
   void SetTopLeft(const Napi::CallbackInfo& info, const Napi::Value& v);
@@ -22,7 +25,9 @@ class RectJs : public Napi::ObjectWrap<RectJs> {
   Napi::Value Area(const Napi::CallbackInfo& info);
 
  private:
-  static Napi::FunctionReference constructor_;
+  static node_binding::LazyExport class_;
 
   Rect rect_;
+  node_binding::MemberViewCache top_left_view_;
+  node_binding::MemberViewCache bottom_right_view_;
 };
@@ -5,8 +5,11 @@
 #ifndef NODE_BINDING_ARG_TYPE_CHECKER_H_
 #define NODE_BINDING_ARG_TYPE_CHECKER_H_
 
-#include <sstream>
+#include <stdio.h>
+
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include "napi.h"
 #include "node_binding/template_util.h"
@@ -14,26 +17,271 @@
 
 namespace node_binding {
 
+namespace internal {
+
+inline void ThrowArgTypeMismatch(Napi::Env env, size_t i) {
+  // Converting may have thrown already, e.g. from a getter.
+  if (env.IsExceptionPending()) return;
+  // Formatted on the stack, so that a mismatch doesn't allocate a stream.
+  char message[48];
+  snprintf(message, sizeof(message), "Type of arg%zu is mismatched", i);
+  Napi::TypeError::New(env, message).ThrowAsJavaScriptException();
+}
+
+// Storage of an argument which is converted while it is checked, see
+// HasTryToNativeValue. Other arguments are converted after all are checked.
+struct NoArgSlot {};
+
+// The storage which TypeConvertor<T> converts an argument into, if it
+// defines
+//
+//   using ArgStorage = ...;
+//   static T ToNativeValue(const Napi::Value& value, ArgStorage* storage);
+//
+// The storage lives until the bound call returns, so T may refer to it,
+// e.g. std::u16string_view.
+template <typename T, typename SFINAE = void>
+struct ArgStorageOf {
+  using Type = NoArgSlot;
+};
+
+template <typename T>
+struct ArgStorageOf<
+    T, std::conditional_t<true, void, typename TypeConvertor<T>::ArgStorage>> {
+  using Type = typename TypeConvertor<T>::ArgStorage;
+};
+
+template <typename T>
+using ArgStorage = typename ArgStorageOf<std::decay_t<T>>::Type;
+
+template <typename T>
+using ArgSlot = std::conditional_t<HasTryToNativeValue<std::decay_t<T>>::value,
+                                   std::decay_t<T>, ArgStorage<T>>;
+
+template <typename... Args>
+using ArgSlots = std::tuple<ArgSlot<Args>...>;
+
+// Slots of arguments which are converted without being checked.
+template <typename... Args>
+using UncheckedArgSlots = std::tuple<ArgStorage<Args>...>;
+
+template <typename T>
+bool CheckArg(const Napi::Value& value, NoArgSlot* slot) {
+  return TypeConvertor<std::decay_t<T>>::IsConvertible(value);
+}
+
+template <typename T>
+bool CheckArg(const Napi::Value& value, std::decay_t<T>* slot) {
+  return TypeConvertor<std::decay_t<T>>::TryToNativeValue(value, slot);
+}
+
+template <typename T>
+bool CheckArg(const Napi::Value& value,
+              typename TypeConvertor<std::decay_t<T>>::ArgStorage* storage) {
+  return TypeConvertor<std::decay_t<T>>::IsConvertible(value);
+}
+
+// Returns an argument checked by CheckArg().
+template <typename T>
+T TakeArg(const Napi::Value& value, NoArgSlot* slot) {
+  return TypeConvertor<T>::ToNativeValue(value);
+}
+
+template <typename T>
+T TakeArg(const Napi::Value& value,
+          typename TypeConvertor<T>::ArgStorage* storage) {
+  return TypeConvertor<T>::ToNativeValue(value, storage);
+}
+
+template <typename T>
+T&& TakeArg(const Napi::Value& value, T* slot) {
+  return std::move(*slot);
+}
+
+}  // namespace internal
+
+// Policies of validating arguments of TypedCall(), which are picked at
+// compile time, so a binding pays only for the checks of its policy.
+//
+//   return TypedCall<TrustedArgs>(info, &Sum);
+//
+// Checks every argument deeply, e.g. each element of a std::vector, and
+// throws a TypeError if any doesn't match. This is the default.
+struct StrictArgs {};
+
+// Coerces arguments of number, string and boolean types like JS does, e.g.
+// "1" into 1 and 1 into "1", instead of throwing. Other arguments are
+// checked strictly.
+struct CoercingArgs {};
+
+// Checks only the JS types of arguments, by JSTypeOf, and converts them
+// without checking deeper, e.g. elements of a std::vector aren't checked. A
+// mismatched element is converted as far as its TypeConvertor can, and may
+// leave a pending exception. Use it for hot bindings whose callers are
+// known to pass valid arguments.
+struct TrustedArgs {};
+
+namespace internal {
+
+// Returns true if the typeof |value| is one of JSTypeOf<T>, which is
+// skipped for types taking any JS type.
+template <typename T>
+bool IsJSTypeOf(const Napi::Value& value) {
+  constexpr uint32_t types = JSTypeOf<T>::kTypes;
+  if (types == JSTypeOf<void>::kTypes) return true;
+  napi_valuetype type = napi_undefined;
+  napi_typeof(value.Env(), value, &type);
+  return (types & (1u << type)) != 0;
+}
+
+template <napi_status (*CoerceTo)(napi_env, napi_value, napi_value*)>
+struct ArgCoercionBy : std::true_type {
+  // Returns false if |value| can't be coerced, e.g. a symbol into a number,
+  // which leaves a pending exception.
+  static bool Coerce(const Napi::Value& value, Napi::Value* result) {
+    napi_value coerced;
+    if (CoerceTo(value.Env(), value, &coerced) != napi_ok) return false;
+    *result = Napi::Value(value.Env(), coerced);
+    return true;
+  }
+};
+
+// How CoercingArgs coerces an argument of type T, which is taken if
+// JSTypeOf<T> is exactly a number, a string or a boolean.
+template <typename T, typename SFINAE = void>
+struct ArgCoercion : std::false_type {};
+
+template <typename T>
+struct ArgCoercion<T, std::enable_if_t<JSTypeOf<T>::kExact &&
+                                       JSTypeOf<T>::kTypes ==
+                                           JSTypeMask(napi_number)>>
+    : ArgCoercionBy<napi_coerce_to_number> {};
+
+template <typename T>
+struct ArgCoercion<T, std::enable_if_t<JSTypeOf<T>::kExact &&
+                                       JSTypeOf<T>::kTypes ==
+                                           JSTypeMask(napi_string)>>
+    : ArgCoercionBy<napi_coerce_to_string> {};
+
+template <typename T>
+struct ArgCoercion<T, std::enable_if_t<JSTypeOf<T>::kExact &&
+                                       JSTypeOf<T>::kTypes ==
+                                           JSTypeMask(napi_boolean)>>
+    : ArgCoercionBy<napi_coerce_to_bool> {};
+
+// The slot of an argument of type T, and how to check it, under Policy.
+template <typename Policy>
+struct ArgPolicy;
+
+template <>
+struct ArgPolicy<StrictArgs> {
+  template <typename T>
+  using Slot = ArgSlot<T>;
+
+  template <typename T, typename S>
+  static bool Check(const Napi::Value& value, S* slot) {
+    return CheckArg<T>(value, slot);
+  }
+};
+
+template <>
+struct ArgPolicy<CoercingArgs> {
+  template <typename T>
+  using Slot = std::conditional_t<ArgCoercion<std::decay_t<T>>::value,
+                                  std::decay_t<T>, ArgSlot<T>>;
+
+  template <typename T, typename S>
+  static bool Check(const Napi::Value& value, S* slot) {
+    return Check<T>(value, slot,
+                    typename ArgCoercion<std::decay_t<T>>::type());
+  }
+
+ private:
+  template <typename T, typename S>
+  static bool Check(const Napi::Value& value, S* slot, std::false_type) {
+    return CheckArg<T>(value, slot);
+  }
+
+  template <typename T>
+  static bool Check(const Napi::Value& value, std::decay_t<T>* slot,
+                    std::true_type) {
+    Napi::Value coerced;
+    if (!ArgCoercion<std::decay_t<T>>::Coerce(value, &coerced)) return false;
+    *slot = TypeConvertor<std::decay_t<T>>::ToNativeValue(coerced);
+    return true;
+  }
+};
+
+template <>
+struct ArgPolicy<TrustedArgs> {
+  template <typename T>
+  using Slot = ArgStorage<T>;
+
+  template <typename T, typename S>
+  static bool Check(const Napi::Value& value, S* slot) {
+    return IsJSTypeOf<std::decay_t<T>>(value);
+  }
+};
+
+template <typename Policy, typename... Args>
+using PolicyArgSlots =
+    std::tuple<typename ArgPolicy<Policy>::template Slot<Args>...>;
+
+}  // namespace internal
+
+// Checks arguments, and converts those in |slots|, which is
+// internal::PolicyArgSlots<Policy, Args...>.
 template <typename... Args>
 struct ArgTypeChecker {
-  static void Check(const Napi::CallbackInfo& info, size_t i, size_t n) {
+  template <typename Policy = StrictArgs, typename Slots>
+  static void Check(const Napi::CallbackInfo& info, size_t i, size_t n,
+                    Slots* slots) {
     return;
   }
+
+  template <typename Slots>
+  static bool Check(napi_env env, const napi_value* args, size_t i, size_t n,
+                    Slots* slots) {
+    return true;
+  }
 };
 
 template <typename T, typename... Rest>
 struct ArgTypeChecker<T, Rest...> {
-  static void Check(const Napi::CallbackInfo& info, size_t i, size_t n) {
+  template <typename Policy = StrictArgs, typename Slots>
+  static void Check(const Napi::CallbackInfo& info, size_t i, size_t n,
+                    Slots* slots) {
     if (i == n) return;
 
-    if (TypeConvertor<std::decay_t<T>>::IsConvertible(info[i])) {
-      return ArgTypeChecker<Rest...>::Check(info, i + 1, n);
+    if (internal::ArgPolicy<Policy>::template Check<T>(info[i], Slot(slots))) {
+      return ArgTypeChecker<Rest...>::template Check<Policy>(info, i + 1, n,
+                                                             slots);
     } else {
-      std::stringstream ss;
-      ss << "Type of arg" << i << " is mismatched";
-      Napi::TypeError::New(info.Env(), ss.str()).ThrowAsJavaScriptException();
+      internal::ThrowArgTypeMismatch(info.Env(), i);
     }
   }
+
+  // Checks |args|, which are fetched without Napi::CallbackInfo. Returns
+  // false if it throws.
+  template <typename Slots>
+  static bool Check(napi_env env, const napi_value* args, size_t i, size_t n,
+                    Slots* slots) {
+    if (i == n) return true;
+
+    if (internal::CheckArg<T>(Napi::Value(env, args[i]), Slot(slots))) {
+      return ArgTypeChecker<Rest...>::Check(env, args, i + 1, n, slots);
+    } else {
+      internal::ThrowArgTypeMismatch(env, i);
+      return false;
+    }
+  }
+
+ private:
+  template <typename Slots>
+  static auto Slot(Slots* slots) {
+    return &std::get<std::tuple_size<Slots>::value - sizeof...(Rest) - 1>(
+        *slots);
+  }
 };
 
 }  // namespace node_binding
@@ -0,0 +1,866 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_CLASS_H_
+#define NODE_BINDING_CLASS_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "napi.h"
+#include "node_binding/command_buffer.h"
+#include "node_binding/constructor.h"
+#include "node_binding/external_memory.h"
+#include "node_binding/field_storage.h"
+#include "node_binding/macros.h"
+#include "node_binding/object_pool.h"
+#include "node_binding/raw_call.h"
+#include "node_binding/reclaimer.h"
+#include "node_binding/transfer.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+namespace internal {
+
+template <typename T>
+void DestroyNative(T* native) {
+  if (DestructionPolicy<T>::value == Destruction::kDeferred) {
+    Reclaimer::GetInstance().Delete(native);
+  } else {
+    DeleteNative(native);
+  }
+}
+
+template <typename T>
+struct IsBoxed
+    : std::integral_constant<bool,
+                             HasExternalMemorySize<T>::value ||
+                                 TransferPolicy<T>::value != Transfer::kNone> {
+};
+
+// Native storage of a Class<T> object, which is the |T| itself.
+template <typename T, bool = IsBoxed<T>::value>
+class ClassInstance {
+ public:
+  static void* New(napi_env env, T* native) { return native; }
+  static T* Get(void* data) { return static_cast<T*>(data); }
+  static void Update(napi_env env, void* data) {}
+  static void Delete(void* data) { DestroyNative(Get(data)); }
+};
+
+// Native storage of a Class<T> object, where |T| has ExternalMemorySize<T>
+// or is transferable. It holds a share of |T|, and reports the size of |T|
+// while the object is alive if ExternalMemorySize<T> is specialized.
+template <typename T>
+class ClassInstance<T, true> {
+ public:
+  static void* New(napi_env env, T* native) {
+    return New(env, std::shared_ptr<T>(native, &DestroyNative<T>));
+  }
+
+  static void* New(napi_env env, std::shared_ptr<T> native) {
+    ClassInstance* instance = new ClassInstance(std::move(native));
+    Update(env, instance);
+    return instance;
+  }
+
+  static T* Get(void* data) {
+    return static_cast<ClassInstance*>(data)->native_.get();
+  }
+
+  static const std::shared_ptr<T>& Share(void* data) {
+    return static_cast<ClassInstance*>(data)->native_;
+  }
+
+  static void Update(napi_env env, void* data) {
+    if (!HasExternalMemorySize<T>::value) return;
+    ClassInstance* instance = static_cast<ClassInstance*>(data);
+    instance->external_memory_.Update(
+        env, sizeof(T) + ExternalMemorySizeOf(*instance->native_));
+  }
+
+  // The size is un-reported on the JS thread, even if |T| is destroyed on the
+  // reclaimer thread or by another owner.
+  static void Delete(void* data) { delete static_cast<ClassInstance*>(data); }
+
+ private:
+  explicit ClassInstance(std::shared_ptr<T> native)
+      : native_(std::move(native)) {}
+
+  std::shared_ptr<T> native_;
+  ExternalMemory external_memory_;
+};
+
+}  // namespace internal
+
+// Defines a JS class for a native class |T| without a hand-written
+// ObjectWrap. Every field and method gets its own static callback, which is
+// specialized for the member pointer, so a call goes straight from N-API to
+// the member without a lookup through callback data. Callbacks are built on
+// RawCall(), so default arguments are not supported.
+//
+//   Napi::Function func =
+//       Class<Rect>("Rect")
+//           .Constructor<>()
+//           .Constructor<const Point&, const Point&>()
+//           .Field("topLeft", NODE_BINDING_MEMBER(&Rect::top_left))
+//           .Method("area", NODE_BINDING_MEMBER(&Rect::Area))
+//           .Define(env);
+//
+// A JS object created by this class owns a |T| allocated by
+// Constructor<T>::CallNew, which is deleted when the object is collected.
+// If ExternalMemorySize<T> is specialized, its size is reported to the JS
+// engine, and updated after setting a field or calling a non-const method.
+// If DestructionPolicy<T> is Destruction::kDeferred, |T| is deleted on the
+// reclaimer thread. If AllocationPolicy<T> is Allocation::kPooled, |T| is
+// allocated from ObjectPool. If StoragePolicy<T> is Storage::kArrayBuffer,
+// |T| lives in an ArrayBuffer of the object, and fields of numbers and bool
+// are accessed by JS without calling into native code.
+//
+// A void method added by Command() is recorded by the CommandBuffer class of
+// the JS class instead of being called, and recorded calls on any objects of
+// the class are run by flush() in a single native call.
+//
+//   const commands = new Calculator.CommandBuffer();
+//   for (const calculator of calculators) commands.increment(calculator, 1);
+//   commands.flush();
+//
+// If TransferPolicy<T> isn't Transfer::kNone, objects get detach(), which
+// hands |T| over to a token and leaves the object unusable, and the class
+// gets adopt(token), which wraps |T| in a new object in any env. For
+// Transfer::kShare, objects also get share(), which makes a token sharing
+// |T| with the object. Tokens are numbers, so they can be posted to workers.
+//
+//   const token = matrix.detach();
+//   worker.postMessage(token);
+//   // In the worker.
+//   const matrix = Matrix.adopt(token);
+template <typename T>
+class Class {
+ public:
+  static_assert(StoragePolicy<T>::value != Storage::kArrayBuffer ||
+                    (std::is_trivially_copyable<T>::value &&
+                     !internal::IsBoxed<T>::value),
+                "Storage::kArrayBuffer needs a trivially copyable T, which "
+                "is neither transferable nor has ExternalMemorySize<T>.");
+
+  explicit Class(const char* name) : name_(name) {
+    AddTransferMethods(
+        std::integral_constant<Transfer, TransferPolicy<T>::value>());
+  }
+
+  // Adds a constructor overload, selected by the number of arguments.
+  template <typename... Args>
+  Class& Constructor() {
+    constructors_.push_back({sizeof...(Args), &Construct<Args...>});
+    return *this;
+  }
+
+  template <typename M, M T::*member>
+  Class& Field(const char* name, std::integral_constant<M T::*, member>) {
+    if (AddBufferField<M>(name, member, true)) return *this;
+    properties_.push_back({name, nullptr, nullptr, &GetField<M, member>,
+                           &SetField<M, member>, nullptr, napi_default,
+                           nullptr});
+    return *this;
+  }
+
+  template <typename M, M T::*member>
+  Class& ReadOnlyField(const char* name,
+                       std::integral_constant<M T::*, member>) {
+    if (AddBufferField<M>(name, member, false)) return *this;
+    properties_.push_back({name, nullptr, nullptr, &GetField<M, member>,
+                           nullptr, nullptr, napi_default, nullptr});
+    return *this;
+  }
+
+  template <typename F, F method>
+  Class& Method(const char* name, std::integral_constant<F, method>) {
+    properties_.push_back({name, nullptr, &CallMethod<F, method>, nullptr,
+                           nullptr, nullptr, napi_default, nullptr});
+    return *this;
+  }
+
+  // Adds a void method of |T| taking numbers or bool as a command of
+  // CommandBuffer. Commands are numbered in the order they are added.
+  template <typename F, F method>
+  Class& Command(const char* name, std::integral_constant<F, method>) {
+    using Signature = internal::Signature<F>;
+    static_assert(std::is_void<typename Signature::ReturnType>::value,
+                  "Commands have to return void.");
+    command_layouts_.push_back(
+        internal::CommandLayoutOf(name, typename Signature::ArgList()));
+    commands_.push_back({command_layouts_.back().size,
+                         &internal::RunCommand<T, F, method>});
+    return *this;
+  }
+
+  template <typename F, F function>
+  Class& StaticMethod(const char* name, std::integral_constant<F, function>) {
+    properties_.push_back({name, nullptr, &RawCall<F, function>, nullptr,
+                           nullptr, nullptr, napi_static, nullptr});
+    return *this;
+  }
+
+  // Defines the JS class in |env| and keeps its constructor for New() until
+  // the env is torn down, so that it can be defined in each worker.
+  Napi::Function Define(Napi::Env env) {
+    ClassData* data =
+        new ClassData{env, {}, constructors_, commands_, {}, nullptr};
+    std::vector<napi_property_descriptor> properties = properties_;
+    for (napi_property_descriptor& property : properties) {
+      property.data = data;
+    }
+
+    napi_value func;
+    napi_status status = napi_define_class(
+        env, name_, NAPI_AUTO_LENGTH, ConstructorCallbackOf(StorageTag()),
+        data, properties.size(), properties.data(), &func);
+    if (status != napi_ok) {
+      delete data;
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return Napi::Function();
+    }
+    if (StoragePolicy<T>::value == Storage::kArrayBuffer &&
+        !DefineBufferFields(Napi::Function(env, func), data)) {
+      delete data;
+      return Napi::Function();
+    }
+    if (!commands_.empty() &&
+        !DefineCommandBuffer(Napi::Function(env, func), data)) {
+      delete data;
+      return Napi::Function();
+    }
+
+    data->constructor = Napi::Persistent(Napi::Function(env, func));
+    {
+      std::lock_guard<std::mutex> lock(mutex());
+      class_data()[env] = data;
+    }
+    napi_add_env_cleanup_hook(env, &Cleanup, data);
+
+    return Napi::Function(env, func);
+  }
+
+  // Creates a JS object owning a copy of |value|, by the class last defined
+  // in |env|.
+  static Napi::Object New(Napi::Env env, const T& value) {
+    ClassData* data;
+    {
+      std::lock_guard<std::mutex> lock(mutex());
+      data = class_data()[env];
+    }
+    Napi::EscapableHandleScope scope(env);
+    napi_value object =
+        NewObject(env, data, Instance::New(env, internal::NewNative<T>(value)));
+    if (object == nullptr) return Napi::Object();
+    return scope.Escape(object).ToObject();
+  }
+
+  // Returns the native object of |value|, or nullptr if |value| is not an
+  // object created by this class.
+  static T* Unwrap(const Napi::Value& value) {
+    void* data = UnwrapData(value.Env(), value);
+    if (data == nullptr) return nullptr;
+    return Instance::Get(data);
+  }
+
+ private:
+  using Instance = internal::ClassInstance<T>;
+  using StorageTag = std::integral_constant<Storage, StoragePolicy<T>::value>;
+
+  struct ConstructorEntry {
+    size_t num_args;
+    // Constructs a |T| in |storage| for Storage::kArrayBuffer. Otherwise
+    // |storage| is null, and |T| is allocated by Constructor<T>::CallNew.
+    T* (*construct)(const Napi::CallbackInfo& info, void* storage);
+  };
+
+  struct CommandEntry {
+    // The number of bytes of a recorded call, including its header.
+    size_t size;
+    void (*run)(T* native, const char* args);
+  };
+
+  // The class defined in an env, which is the data of its callbacks.
+  struct ClassData {
+    napi_env env;
+    Napi::FunctionReference constructor;
+    std::vector<ConstructorEntry> constructors;
+    std::vector<CommandEntry> commands;
+    // The function keeping the DataView of an object for
+    // Storage::kArrayBuffer out of reach of JS.
+    Napi::FunctionReference attach_buffer;
+    // The instance NewObject() is constructing an object of, which JS can't
+    // pass to the constructor.
+    void* pending_instance;
+  };
+
+  static std::mutex& mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // The class last defined in each env.
+  static std::unordered_map<napi_env, ClassData*>& class_data() {
+    static std::unordered_map<napi_env, ClassData*> class_data;
+    return class_data;
+  }
+
+  static void Cleanup(void* arg) {
+    ClassData* data = static_cast<ClassData*>(arg);
+    {
+      std::lock_guard<std::mutex> lock(mutex());
+      auto it = class_data().find(data->env);
+      if (it != class_data().end() && it->second == data) {
+        class_data().erase(it);
+      }
+    }
+    data->constructor.Reset();
+    data->attach_buffer.Reset();
+    delete data;
+  }
+
+  // Creates an object wrapping |instance|, which is deleted on failure.
+  static napi_value NewObject(napi_env env, ClassData* data, void* instance) {
+    if (data == nullptr) {
+      Instance::Delete(instance);
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    // The constructor takes |instance| before it runs any JS, and deletes it
+    // on failure.
+    data->pending_instance = instance;
+    napi_value object = nullptr;
+    napi_status status = napi_new_instance(env, data->constructor.Value(), 0,
+                                           nullptr, &object);
+    if (data->pending_instance != nullptr) {
+      data->pending_instance = nullptr;
+      Instance::Delete(instance);
+    }
+    if (status != napi_ok) {
+      if (!Napi::Env(env).IsExceptionPending()) {
+        Napi::Error::New(env).ThrowAsJavaScriptException();
+      }
+      return nullptr;
+    }
+    return object;
+  }
+
+  // Returns the instance passed by NewObject() and clears it, or nullptr if
+  // the constructor is called from JS.
+  static void* TakePendingInstance(const Napi::CallbackInfo& info) {
+    ClassData* class_data = static_cast<ClassData*>(info.Data());
+    void* instance = class_data->pending_instance;
+    class_data->pending_instance = nullptr;
+    return instance;
+  }
+
+  // Checks arguments as TypedCall() does, since overloads are selected only
+  // by the number of arguments, and constructs |T| from the checked slots.
+  template <typename... Args>
+  static T* Construct(const Napi::CallbackInfo& info, void* storage) {
+    NODE_BINDING_TRACE_CALL("TypedConstruct");
+    using Slots = internal::PolicyArgSlots<StrictArgs, Args...>;
+    Slots arg_slots;
+    ArgTypeChecker<Args...>::Check(info, 0, sizeof...(Args), &arg_slots);
+    if (info.Env().IsExceptionPending()) return nullptr;
+    NODE_BINDING_TRACE_ARGS_CHECKED();
+    return Construct<Args...>(info, &arg_slots, storage, StorageTag());
+  }
+
+  template <typename... Args, typename Slots>
+  static T* Construct(const Napi::CallbackInfo& info, Slots* arg_slots,
+                      void* storage,
+                      std::integral_constant<Storage, Storage::kNative>) {
+    return internal::Invoke(
+        info, arg_slots,
+        &::node_binding::Constructor<T>::template CallNew<Args...>,
+        std::make_index_sequence<sizeof...(Args)>());
+  }
+
+  template <typename... Args, typename Slots>
+  static T* Construct(const Napi::CallbackInfo& info, Slots* arg_slots,
+                      void* storage,
+                      std::integral_constant<Storage, Storage::kArrayBuffer>) {
+    return new (storage) T(internal::Invoke(
+        info, arg_slots,
+        &::node_binding::Constructor<T>::template Call<Args...>,
+        std::make_index_sequence<sizeof...(Args)>()));
+  }
+
+  // Returns the constructor of |T| matching the number of arguments, or
+  // throws.
+  static const ConstructorEntry* FindConstructor(
+      const Napi::CallbackInfo& info) {
+    ClassData* class_data = static_cast<ClassData*>(info.Data());
+    for (const ConstructorEntry& entry : class_data->constructors) {
+      if (entry.num_args == info.Length()) return &entry;
+    }
+    THROW_JS_WRONG_NUMBER_OF_ARGUMENTS(info.Env());
+    return nullptr;
+  }
+
+  static void Finalize(napi_env env, void* data, void* hint) {
+    NODE_BINDING_TRACE_SCOPE("Finalize");
+    UntagData(data);
+    Instance::Delete(data);
+  }
+
+  // Returns the finalizer of an object of Storage::kArrayBuffer, whose data
+  // is freed with its buffer.
+  static napi_finalize BufferFinalizer() {
+#if NAPI_VERSION >= 8
+    return nullptr;
+#else
+    return [](napi_env env, void* data, void* hint) { UntagData(data); };
+#endif
+  }
+
+  static napi_value ConstructorCallback(napi_env env,
+                                        napi_callback_info cbinfo) {
+    Napi::CallbackInfo info(env, cbinfo);
+    void* data = TakePendingInstance(info);
+    if (data == nullptr) {
+      const ConstructorEntry* entry = FindConstructor(info);
+      if (entry == nullptr) return nullptr;
+      T* native = entry->construct(info, nullptr);
+      if (native == nullptr) return nullptr;
+      if (info.Env().IsExceptionPending()) {
+        internal::DeleteNative(native);
+        return nullptr;
+      }
+      data = Instance::New(env, native);
+    }
+
+    if (!TagObject(env, info.This(), data)) {
+      Instance::Delete(data);
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    if (napi_wrap(env, info.This(), data, &Finalize, nullptr, nullptr) !=
+        napi_ok) {
+      UntagData(data);
+      Instance::Delete(data);
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    return info.This();
+  }
+
+  static napi_callback ConstructorCallbackOf(
+      std::integral_constant<Storage, Storage::kNative>) {
+    return &ConstructorCallback;
+  }
+
+  static napi_callback ConstructorCallbackOf(
+      std::integral_constant<Storage, Storage::kArrayBuffer>) {
+    return &ArrayBufferConstructorCallback;
+  }
+
+  // Constructs |T| in an ArrayBuffer, and keeps a DataView of it in a
+  // private field of the object for accessors defined by
+  // DefineBufferFields(). |T| is trivially
+  // destructible, so the object is wrapped without a finalizer and the
+  // buffer is freed with it.
+  static napi_value ArrayBufferConstructorCallback(napi_env env,
+                                                   napi_callback_info cbinfo) {
+    Napi::CallbackInfo info(env, cbinfo);
+    ClassData* class_data = static_cast<ClassData*>(info.Data());
+    // The instance passed by NewObject() is copied.
+    T* instance = static_cast<T*>(TakePendingInstance(info));
+    const ConstructorEntry* entry = nullptr;
+    if (instance == nullptr) {
+      entry = FindConstructor(info);
+      if (entry == nullptr) return nullptr;
+    }
+
+    void* storage;
+    napi_value buffer;
+    if (napi_create_arraybuffer(env, sizeof(T), &storage, &buffer) !=
+        napi_ok) {
+      internal::DeleteNative(instance);
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    if (instance != nullptr) {
+      new (storage) T(*instance);
+      internal::DeleteNative(instance);
+    } else if (entry->construct(info, storage) == nullptr ||
+               info.Env().IsExceptionPending()) {
+      return nullptr;
+    }
+
+    napi_value view;
+    if (napi_create_dataview(env, sizeof(T), buffer, 0, &view) != napi_ok) {
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    class_data->attach_buffer.Call({info.This(), Napi::Value(env, view)});
+    if (info.Env().IsExceptionPending()) return nullptr;
+    if (!TagObject(env, info.This(), storage)) {
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    if (napi_wrap(env, info.This(), storage, BufferFinalizer(), nullptr,
+                  nullptr) != napi_ok) {
+      UntagData(storage);
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    return info.This();
+  }
+
+  // Adds a field of |M| accessed through a DataView, if |T| lives in an
+  // ArrayBuffer and |M| is a number or bool.
+  template <typename M>
+  bool AddBufferField(const char* name, M T::*member, bool writable) {
+    const char* type = internal::DataViewTypeOf<M>();
+    if (StoragePolicy<T>::value != Storage::kArrayBuffer || type == nullptr) {
+      return false;
+    }
+    buffer_fields_.push_back({name, internal::OffsetOf(member), type,
+                              std::is_same<M, bool>::value, writable});
+    return true;
+  }
+
+  // Defines accessors of |buffer_fields_| on the prototype of |func| in JS,
+  // and keeps the function attaching DataViews to objects of |func| in
+  // |data|. Returns false if it throws.
+  bool DefineBufferFields(Napi::Function func, ClassData* data) {
+    Napi::Env env = func.Env();
+    Napi::Value define = internal::RunScript(
+        env, internal::BufferFieldsSource(buffer_fields_).c_str());
+    if (define.IsEmpty()) return false;
+    Napi::Value attach =
+        define.As<Napi::Function>().Call({func.Get("prototype")});
+    if (env.IsExceptionPending()) return false;
+    data->attach_buffer = Napi::Persistent(attach.As<Napi::Function>());
+    return true;
+  }
+
+  // Defines the CommandBuffer class of |func|, which records |commands_|,
+  // in JS. Returns false if it throws.
+  bool DefineCommandBuffer(Napi::Function func, ClassData* data) {
+    Napi::Env env = func.Env();
+    for (const internal::CommandLayout& command : command_layouts_) {
+      if (internal::IsReservedCommandName(command.name)) {
+        Napi::Error::New(env, "Name of command is reserved")
+            .ThrowAsJavaScriptException();
+        return false;
+      }
+    }
+
+    napi_value flush;
+    if (napi_create_function(env, "flush", NAPI_AUTO_LENGTH,
+                             &FlushCommandsCallback, data,
+                             &flush) != napi_ok) {
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return false;
+    }
+
+    Napi::Value define = internal::RunScript(
+        env, internal::CommandBufferSource(command_layouts_).c_str());
+    if (define.IsEmpty()) return false;
+    Napi::Value command_buffer =
+        define.As<Napi::Function>().Call({Napi::Value(env, flush), func});
+    if (env.IsExceptionPending()) return false;
+    func.Set("CommandBuffer", command_buffer);
+    return !env.IsExceptionPending();
+  }
+
+  // Runs commands recorded in the first |length| bytes of an ArrayBuffer,
+  // whose handles index an array of objects. The recorder checks objects by
+  // instanceof, which a prototype can fake, so each object is checked by its
+  // tag and unwrapped once here, however many commands it has. The
+  // whole buffer is validated before any command runs, so an invalid buffer
+  // runs none of them.
+  static napi_value FlushCommandsCallback(napi_env env,
+                                          napi_callback_info cbinfo) {
+    size_t argc = 3;
+    napi_value args[3];
+    void* class_data;
+    napi_get_cb_info(env, cbinfo, &argc, args, nullptr, &class_data);
+    ClassData* data = static_cast<ClassData*>(class_data);
+
+    void* buffer;
+    size_t capacity;
+    uint32_t length;
+    uint32_t num_objects;
+    if (argc != 3 ||
+        napi_get_arraybuffer_info(env, args[0], &buffer, &capacity) !=
+            napi_ok ||
+        napi_get_value_uint32(env, args[1], &length) != napi_ok ||
+        length > capacity ||
+        napi_get_array_length(env, args[2], &num_objects) != napi_ok) {
+      Napi::TypeError::New(env, "Invalid command buffer")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+
+    std::vector<void*> objects(num_objects);
+    for (uint32_t i = 0; i < num_objects; ++i) {
+      napi_value object;
+      if (napi_get_element(env, args[2], i, &object) != napi_ok ||
+          (objects[i] = UnwrapData(env, object)) == nullptr) {
+        if (!Napi::Env(env).IsExceptionPending()) {
+          Napi::TypeError::New(env, "Illegal invocation")
+              .ThrowAsJavaScriptException();
+        }
+        return nullptr;
+      }
+    }
+
+    const char* commands = static_cast<const char*>(buffer);
+    if (!IsValidCommands(data, commands, length, num_objects)) {
+      Napi::TypeError::New(env, "Invalid command buffer")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+
+    uint32_t header[2];
+    for (size_t offset = 0; offset < length;) {
+      memcpy(header, commands + offset, sizeof(header));
+      const CommandEntry& command = data->commands[header[1]];
+      command.run(Instance::Get(objects[header[0]]),
+                  commands + offset + internal::kCommandHeaderSize);
+      offset += command.size;
+    }
+    for (void* object : objects) Instance::Update(env, object);
+    return nullptr;
+  }
+
+  // Returns whether |length| bytes of |commands| are whole commands of the
+  // class, on |num_objects| objects.
+  static bool IsValidCommands(const ClassData* data, const char* commands,
+                              size_t length, size_t num_objects) {
+    uint32_t header[2];
+    for (size_t offset = 0; offset < length;) {
+      if (length - offset < internal::kCommandHeaderSize) return false;
+      memcpy(header, commands + offset, sizeof(header));
+      if (header[0] >= num_objects || header[1] >= data->commands.size() ||
+          length - offset < data->commands[header[1]].size) {
+        return false;
+      }
+      offset += data->commands[header[1]].size;
+    }
+    return true;
+  }
+
+#if NAPI_VERSION >= 8
+  // Returns a tag of objects of the class, which is unique to |T|, since it
+  // is made of its own address.
+  static const napi_type_tag* TypeTag() {
+    static const napi_type_tag tag = {
+        static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&tag)),
+        0x4e6f646542696e64};
+    return &tag;
+  }
+#else
+  // The number of objects wrapping each native data of the class, which
+  // stands for type tags before N-API 8. An object is counted until it is
+  // finalized, which may be after its data is freed and reused.
+  static std::unordered_map<void*, size_t>& tagged_data() {
+    static std::unordered_map<void*, size_t> tagged_data;
+    return tagged_data;
+  }
+#endif
+
+  // Tags |object|, which is about to wrap |data|, as an object of the class.
+  static bool TagObject(napi_env env, napi_value object, void* data) {
+#if NAPI_VERSION >= 8
+    return napi_type_tag_object(env, object, TypeTag()) == napi_ok;
+#else
+    std::lock_guard<std::mutex> lock(mutex());
+    ++tagged_data()[data];
+    return true;
+#endif
+  }
+
+  // Drops the tag of an object, which no longer wraps |data|.
+  static void UntagData(void* data) {
+#if NAPI_VERSION < 8
+    std::lock_guard<std::mutex> lock(mutex());
+    auto it = tagged_data().find(data);
+    if (it != tagged_data().end() && --it->second == 0) {
+      tagged_data().erase(it);
+    }
+#endif
+  }
+
+  // Returns whether |object|, which wraps |data|, is tagged by TagObject().
+  static bool IsTagged(napi_env env, napi_value object, void* data) {
+#if NAPI_VERSION >= 8
+    bool is_tagged = false;
+    return napi_check_object_type_tag(env, object, TypeTag(), &is_tagged) ==
+               napi_ok &&
+           is_tagged;
+#else
+    std::lock_guard<std::mutex> lock(mutex());
+    return tagged_data().count(data) != 0;
+#endif
+  }
+
+  // Returns the native data of |object|, or nullptr if it isn't an object of
+  // the class. Every wrapped object is unwrapped alike, so |object| is
+  // checked by its tag before being taken for a |T|.
+  static void* UnwrapData(napi_env env, napi_value object) {
+    void* data = nullptr;
+    if (napi_unwrap(env, object, &data) != napi_ok ||
+        !IsTagged(env, object, data)) {
+      return nullptr;
+    }
+    return data;
+  }
+
+  static void* ThisData(napi_env env, napi_value this_arg) {
+    void* data = UnwrapData(env, this_arg);
+    if (data == nullptr) {
+      Napi::TypeError::New(env, "Illegal invocation")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    return data;
+  }
+
+  static T* This(napi_env env, napi_value this_arg) {
+    void* data = ThisData(env, this_arg);
+    if (data == nullptr) return nullptr;
+    return Instance::Get(data);
+  }
+
+  void AddTransferMethods(std::integral_constant<Transfer, Transfer::kNone>) {}
+
+  template <Transfer policy>
+  void AddTransferMethods(std::integral_constant<Transfer, policy>) {
+    properties_.push_back({"detach", nullptr, &DetachCallback, nullptr,
+                           nullptr, nullptr, napi_default, nullptr});
+    if (policy == Transfer::kShare) {
+      properties_.push_back({"share", nullptr, &ShareCallback, nullptr,
+                             nullptr, nullptr, napi_default, nullptr});
+    }
+    properties_.push_back({"adopt", nullptr, &AdoptCallback, nullptr, nullptr,
+                           nullptr, napi_static, nullptr});
+  }
+
+  static napi_value DetachCallback(napi_env env, napi_callback_info cbinfo) {
+    napi_value this_arg;
+    napi_get_cb_info(env, cbinfo, nullptr, nullptr, &this_arg, nullptr);
+    void* data = ThisData(env, this_arg);
+    if (data == nullptr) return nullptr;
+
+    // The object is no longer finalized, and its methods throw.
+    napi_remove_wrap(env, this_arg, &data);
+    UntagData(data);
+    uint64_t token =
+        TransferRegistry::GetInstance().Put(Instance::Share(data));
+    Instance::Delete(data);
+    return Napi::Number::New(env, static_cast<double>(token));
+  }
+
+  static napi_value ShareCallback(napi_env env, napi_callback_info cbinfo) {
+    napi_value this_arg;
+    napi_get_cb_info(env, cbinfo, nullptr, nullptr, &this_arg, nullptr);
+    void* data = ThisData(env, this_arg);
+    if (data == nullptr) return nullptr;
+
+    uint64_t token =
+        TransferRegistry::GetInstance().Put(Instance::Share(data));
+    return Napi::Number::New(env, static_cast<double>(token));
+  }
+
+  static napi_value AdoptCallback(napi_env env, napi_callback_info cbinfo) {
+    size_t argc = 1;
+    napi_value arg;
+    void* class_data;
+    napi_get_cb_info(env, cbinfo, &argc, &arg, nullptr, &class_data);
+
+    int64_t token = 0;
+    if (argc == 1) napi_get_value_int64(env, arg, &token);
+    std::shared_ptr<T> native =
+        token > 0 ? TransferRegistry::GetInstance().Take<T>(token) : nullptr;
+    if (!native) {
+      Napi::TypeError::New(env, "Invalid transfer token")
+          .ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    return NewObject(env, static_cast<ClassData*>(class_data),
+                     Instance::New(env, std::move(native)));
+  }
+
+  template <typename M, M T::*member>
+  static napi_value GetField(napi_env env, napi_callback_info cbinfo) {
+    napi_value this_arg;
+    napi_get_cb_info(env, cbinfo, nullptr, nullptr, &this_arg, nullptr);
+
+    T* native = This(env, this_arg);
+    if (native == nullptr) return nullptr;
+    return internal::RawResult(env, cbinfo, native->*member, 0);
+  }
+
+  template <typename M, M T::*member>
+  static napi_value SetField(napi_env env, napi_callback_info cbinfo) {
+    // A setter takes exactly one argument, so fetch it without
+    // Napi::CallbackInfo.
+    size_t argc = 1;
+    napi_value arg;
+    napi_value this_arg;
+    napi_get_cb_info(env, cbinfo, &argc, &arg, &this_arg, nullptr);
+
+    void* data = ThisData(env, this_arg);
+    if (data == nullptr) return nullptr;
+    T* native = Instance::Get(data);
+    if (!internal::TryConvert<M>(Napi::Value(env, arg), [native](auto&& value) {
+          native->*member = std::forward<decltype(value)>(value);
+        })) {
+      if (!Napi::Env(env).IsExceptionPending()) {
+        Napi::TypeError::New(env, "Type of value is mismatched")
+            .ThrowAsJavaScriptException();
+      }
+      return nullptr;
+    }
+    Instance::Update(env, data);
+    return nullptr;
+  }
+
+  template <typename F, F method>
+  static std::enable_if_t<internal::Signature<F>::kIsConst ||
+                              !HasExternalMemorySize<T>::value,
+                          napi_value>
+  CallMethod(napi_env env, napi_callback_info cbinfo) {
+    return RawCall<F, method>(env, cbinfo, &This);
+  }
+
+  // A non-const method may change the size of |T|.
+  template <typename F, F method>
+  static std::enable_if_t<!internal::Signature<F>::kIsConst &&
+                              HasExternalMemorySize<T>::value,
+                          napi_value>
+  CallMethod(napi_env env, napi_callback_info cbinfo) {
+    napi_value result = RawCall<F, method>(env, cbinfo, &This);
+    napi_value this_arg;
+    napi_get_cb_info(env, cbinfo, nullptr, nullptr, &this_arg, nullptr);
+    void* data = UnwrapData(env, this_arg);
+    if (data != nullptr) Instance::Update(env, data);
+    return result;
+  }
+
+  const char* name_;
+  std::vector<ConstructorEntry> constructors_;
+  std::vector<napi_property_descriptor> properties_;
+  std::vector<internal::BufferField> buffer_fields_;
+  std::vector<CommandEntry> commands_;
+  std::vector<internal::CommandLayout> command_layouts_;
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_CLASS_H_
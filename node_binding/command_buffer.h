@@ -0,0 +1,208 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_COMMAND_BUFFER_H_
+#define NODE_BINDING_COMMAND_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "node_binding/field_storage.h"
+#include "node_binding/lazy_export.h"
+#include "node_binding/raw_call.h"
+#include "node_binding/template_util.h"
+
+namespace node_binding {
+
+namespace internal {
+
+// A command recorded by a CommandBuffer starts with the handle of its object
+// and its method id, as uint32 in native byte order, followed by its
+// arguments packed without padding.
+constexpr size_t kCommandHeaderSize = 8;
+
+// Returns the number of bytes of an argument of |Arg| in a command.
+template <typename Arg>
+constexpr size_t CommandArgSize() {
+  static_assert(DataViewTypeOf<Arg>() != nullptr,
+                "Arguments of commands have to be numbers or bool, except "
+                "64-bit integers.");
+  return std::is_same<Arg, bool>::value ? 1 : sizeof(Arg);
+}
+
+// Returns the offset of the |index|th argument of a command taking |Args|,
+// from the end of its header. For |index| == sizeof...(Args), it is the
+// size of all of them.
+template <typename... Args>
+constexpr size_t CommandArgOffset(size_t index) {
+  const size_t sizes[] = {CommandArgSize<Args>()..., 0};
+  size_t offset = 0;
+  for (size_t i = 0; i < index; ++i) offset += sizes[i];
+  return offset;
+}
+
+template <typename Arg>
+Arg ReadCommandArg(const char* data) {
+  Arg value;
+  memcpy(&value, data, sizeof(Arg));
+  return value;
+}
+
+// bool is recorded as a byte, so that any byte is read as a valid bool.
+template <>
+inline bool ReadCommandArg<bool>(const char* data) {
+  return *reinterpret_cast<const uint8_t*>(data) != 0;
+}
+
+template <typename T, typename F, F method, typename... Args, size_t... I>
+void RunCommand(T* object, const char* args, TypeList<Args...>,
+                std::index_sequence<I...>) {
+  (void)args;
+  (object->*method)(ReadCommandArg<std::decay_t<Args>>(
+      args + CommandArgOffset<std::decay_t<Args>...>(I))...);
+}
+
+// Runs a recorded call of |method| on |object|, reading its arguments from
+// |args|, which has been validated to hold them.
+template <typename T, typename F, F method>
+void RunCommand(T* object, const char* args) {
+  RunCommand<T, F, method>(
+      object, args, typename Signature<F>::ArgList(),
+      std::make_index_sequence<Signature<F>::kNumArgs>());
+}
+
+// An argument of a command, as written by the recorder.
+struct CommandArg {
+  // The DataView accessor type, e.g. "Int32" for setInt32().
+  const char* type;
+  size_t size;
+  bool is_bool;
+};
+
+// A method of a recorder, which appends a command of |size| bytes.
+struct CommandLayout {
+  const char* name;
+  std::vector<CommandArg> args;
+  size_t size;
+};
+
+template <typename... Args>
+CommandLayout CommandLayoutOf(const char* name, TypeList<Args...>) {
+  return {name,
+          {{DataViewTypeOf<std::decay_t<Args>>(),
+            CommandArgSize<std::decay_t<Args>>(),
+            std::is_same<std::decay_t<Args>, bool>::value}...},
+          kCommandHeaderSize + CommandArgOffset<std::decay_t<Args>...>(
+                                   sizeof...(Args))};
+}
+
+// Returns whether |name| is taken by a member of CommandBuffer itself, and
+// can't be the name of a command.
+inline bool IsReservedCommandName(const char* name) {
+  const size_t length = strlen(name);
+  return strcmp(name, "constructor") == 0 || strcmp(name, "flush") == 0 ||
+         strcmp(name, "byteLength") == 0 ||
+         (length > 0 && name[length - 1] == '_');
+}
+
+// Returns the source of a function, which takes the native flush callback
+// and the JS class, and returns the recorder class of |commands|. The method
+// id of a command is its index in |commands|. Arguments are type-checked as
+// they are recorded, and objects when they are first recorded in a buffer.
+inline std::string CommandBufferSource(
+    const std::vector<CommandLayout>& commands) {
+  const std::string le = IsLittleEndian() ? "true" : "false";
+  std::string source =
+      "(function(flush, Class) {\n"
+      "  'use strict';\n"
+      "  class CommandBuffer {\n"
+      "    constructor(capacity = 4096) {\n"
+      "      this.view_ = new DataView(new ArrayBuffer(capacity));\n"
+      "      this.length_ = 0;\n"
+      "      this.objects_ = [];\n"
+      "      this.handles_ = new Map();\n"
+      "      this.last_ = undefined;\n"
+      "      this.lastHandle_ = 0;\n"
+      "    }\n"
+      "    get byteLength() { return this.length_; }\n"
+      "    flush() {\n"
+      "      if (this.length_ === 0) return;\n"
+      "      const {view_, length_, objects_} = this;\n"
+      "      this.length_ = 0;\n"
+      "      this.objects_ = [];\n"
+      "      this.handles_.clear();\n"
+      "      this.last_ = undefined;\n"
+      "      flush(view_.buffer, length_, objects_);\n"
+      "    }\n"
+      "    handle_(object) {\n"
+      "      if (object === this.last_) return this.lastHandle_;\n"
+      "      let handle = this.handles_.get(object);\n"
+      "      if (handle === undefined) {\n"
+      "        if (!(object instanceof Class)) {\n"
+      "          throw new TypeError('Illegal invocation');\n"
+      "        }\n"
+      "        handle = this.objects_.push(object) - 1;\n"
+      "        this.handles_.set(object, handle);\n"
+      "      }\n"
+      "      this.last_ = object;\n"
+      "      this.lastHandle_ = handle;\n"
+      "      return handle;\n"
+      "    }\n"
+      "    append_(object, method, size) {\n"
+      "      const at = this.length_;\n"
+      "      if (at + size > this.view_.byteLength) {\n"
+      "        const buffer = new ArrayBuffer(\n"
+      "            Math.max(2 * this.view_.byteLength, at + size));\n"
+      "        new Uint8Array(buffer).set(\n"
+      "            new Uint8Array(this.view_.buffer, 0, at));\n"
+      "        this.view_ = new DataView(buffer);\n"
+      "      }\n"
+      "      this.view_.setUint32(at, this.handle_(object), " + le + ");\n"
+      "      this.view_.setUint32(at + 4, method, " + le + ");\n"
+      "      this.length_ = at + size;\n"
+      "      return at + " + std::to_string(kCommandHeaderSize) + ";\n"
+      "    }\n";
+  for (size_t method = 0; method < commands.size(); ++method) {
+    const CommandLayout& command = commands[method];
+    std::string params = "object";
+    std::string checks;
+    std::string writes;
+    size_t offset = 0;
+    for (size_t i = 0; i < command.args.size(); ++i) {
+      const CommandArg& arg = command.args[i];
+      std::string name = "a" + std::to_string(i);
+      params += ", " + name;
+      checks += std::string("      if (typeof ") + name + " !== '" +
+                (arg.is_bool ? "boolean" : "number") + "') {\n" +
+                "        throw new TypeError('Type of argument is "
+                "mismatched');\n"
+                "      }\n";
+      writes += std::string("      this.view_.set") + arg.type + "(at + " +
+                std::to_string(offset) + ", " + name +
+                (arg.is_bool ? " ? 1 : 0" : ", " + le) + ");\n";
+      offset += arg.size;
+    }
+    source += "    " + QuoteJS(command.name) + "(" + params + ") {\n" +
+              checks + "      const at = this.append_(object, " +
+              std::to_string(method) + ", " + std::to_string(command.size) +
+              ");\n" + writes + "    }\n";
+  }
+  source +=
+      "  }\n"
+      "  return CommandBuffer;\n"
+      "})";
+  return source;
+}
+
+}  // namespace internal
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_COMMAND_BUFFER_H_
@@ -5,6 +5,7 @@
 #ifndef NODE_BINDING_CONSTRUCTOR_H_
 #define NODE_BINDING_CONSTRUCTOR_H_
 
+#include "node_binding/object_pool.h"
 #include "node_binding/typed_call.h"
 
 namespace node_binding {
@@ -16,20 +17,26 @@ struct Constructor {
     return Class(std::forward<Args>(args)...);
   };
 
+  // Allocates as AllocationPolicy<Class> says, so free it by
+  // NativeDeleter<Class>.
   template <typename... Args>
   static Class* CallNew(Args&&... args) {
-    return new Class(std::forward<Args>(args)...);
+    return internal::NewNative<Class>(std::forward<Args>(args)...);
   };
 };
 
 template <typename R, typename... Args, typename... DefaultArgs>
 R TypedConstruct(const Napi::CallbackInfo& info, R (*f)(Args...),
                  DefaultArgs&&... def_args) {
+  NODE_BINDING_TRACE_CALL("TypedConstruct");
   constexpr size_t num_args = sizeof...(Args) - sizeof...(DefaultArgs);
   JS_CHECK_NUM_ARGS(info, num_args);
   // TODO: How can stop calling constructor if there has a pending exception?
+  NODE_BINDING_TRACE_ARGS_CHECKED();
 
-  return internal::Invoke(info, f, std::make_index_sequence<num_args>(),
+  internal::UncheckedArgSlots<Args...> arg_slots;
+  return internal::Invoke(info, &arg_slots, f,
+                          std::make_index_sequence<num_args>(),
                           std::forward<DefaultArgs>(def_args)...);
 }
 
@@ -0,0 +1,423 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_COROUTINE_H_
+#define NODE_BINDING_COROUTINE_H_
+
+#if __cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L)
+#error "node_binding/coroutine.h requires C++20."
+#endif
+
+#include <coroutine>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "napi.h"
+#include "node_binding/trace.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+namespace internal {
+
+// The part of a promise of Task<T> which doesn't depend on T. It settles
+// the JS promise returned to the caller of the bound function.
+class TaskPromiseBase {
+ public:
+  napi_env env() const { return env_; }
+
+  void Start(napi_env env, napi_deferred deferred) {
+    env_ = env;
+    deferred_ = deferred;
+  }
+
+  void Reject(napi_value reason) {
+    napi_reject_deferred(env_, deferred_, reason);
+  }
+
+  // Rejects with the pending JS exception, if any. A coroutine doesn't
+  // return to JS at a suspension point, so an exception thrown by a JS call
+  // before it would otherwise be left to whoever resumed the coroutine.
+  bool RejectIfThrown() {
+    bool pending;
+    napi_is_exception_pending(env_, &pending);
+    if (!pending) return false;
+    napi_value error;
+    napi_get_and_clear_last_exception(env_, &error);
+    Reject(error);
+    return true;
+  }
+
+ protected:
+  napi_env env_ = nullptr;
+  napi_deferred deferred_ = nullptr;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+ public:
+  void return_value(T value) { value_.emplace(std::move(value)); }
+
+ protected:
+  void Resolve() {
+    napi_value value = ToJSValue(Napi::Env(env_), std::move(*value_));
+    if (RejectIfThrown()) return;
+    napi_resolve_deferred(env_, deferred_, value);
+  }
+
+ private:
+  std::optional<T> value_;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+ public:
+  void return_void() {}
+
+ protected:
+  void Resolve() {
+    napi_value value;
+    napi_get_undefined(env_, &value);
+    napi_resolve_deferred(env_, deferred_, value);
+  }
+};
+
+// Keeps the suspended coroutine of a Task<T> for an awaiter, which resumes
+// it on the JS thread or rejects the task and destroys the coroutine.
+class TaskAwaiter {
+ public:
+  bool await_ready() const noexcept { return false; }
+
+ protected:
+  // Returns false if the task was rejected with a pending exception instead.
+  template <typename Promise>
+  bool Suspend(std::coroutine_handle<Promise> handle) {
+    static_assert(std::is_base_of<TaskPromiseBase, Promise>::value,
+                  "It can only be awaited in Task<T>.");
+    task_ = &handle.promise();
+    handle_ = handle;
+    if (!task_->RejectIfThrown()) return true;
+    handle_.destroy();
+    return false;
+  }
+
+  napi_env env() const { return task_->env(); }
+
+  void Resume() { handle_.resume(); }
+
+  // Destroys the coroutine, including this awaiter, which must not be used
+  // afterwards.
+  void Reject(napi_value reason) {
+    std::coroutine_handle<> handle = handle_;
+    task_->Reject(reason);
+    handle.destroy();
+  }
+
+  void Reject(const char* message) {
+    Reject(Napi::Error::New(Napi::Env(env()), message).Value());
+  }
+
+ private:
+  TaskPromiseBase* task_ = nullptr;
+  std::coroutine_handle<> handle_;
+};
+
+template <typename T>
+class AwaitedValue {
+ public:
+  T await_resume() { return std::move(*value_); }
+
+ protected:
+  std::optional<T> value_;
+};
+
+template <>
+class AwaitedValue<void> {
+ public:
+  void await_resume() {}
+};
+
+}  // namespace internal
+
+// A coroutine returned by a bound function, which the caller gets as a JS
+// promise. It starts when it is converted to the promise, runs on the JS
+// thread between suspension points, and resolves the promise with the value
+// of co_return converted by TypeConvertor<T>.
+//
+//   Task<uint64_t> Fib(uint32_t n) {
+//     co_return co_await RunInBackground([n]() { return FibSlow(n); });
+//   }
+//
+// The promise is rejected, and the coroutine is destroyed at its suspension
+// point, if an awaited promise is rejected, if it co_awaits Reject(), or if
+// a JS exception is pending when it suspends or returns. A Task<T> which is
+// never converted is destroyed without running. A task suspended when its
+// env is torn down is never resumed nor destroyed.
+template <typename T>
+class Task {
+ public:
+  class promise_type : public internal::TaskPromise<T> {
+   public:
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // The coroutine destroys itself once the JS promise is settled.
+    std::suspend_never final_suspend() noexcept {
+      if (!this->RejectIfThrown()) this->Resolve();
+      return {};
+    }
+
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task(const Task& other) = delete;
+  Task& operator=(const Task& other) = delete;
+
+  ~Task() {
+    if (handle_) handle_.destroy();
+  }
+
+  // Runs the coroutine until its first suspension point and returns the
+  // promise of its result.
+  Napi::Value Start(Napi::Env env) {
+    napi_deferred deferred;
+    napi_value promise;
+    if (napi_create_promise(env, &deferred, &promise) != napi_ok) {
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return Napi::Value();
+    }
+    std::coroutine_handle<promise_type> handle = std::exchange(handle_, {});
+    handle.promise().Start(env, deferred);
+    handle.resume();
+    return Napi::Value(env, promise);
+  }
+
+ private:
+  explicit Task(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T>
+class TypeConvertor<Task<T>> {
+ public:
+  static Napi::Value ToJSValue(Napi::Env env, Task<T> value) {
+    return value.Start(env);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info, Task<T> value) {
+    return value.Start(info.Env());
+  }
+};
+
+// Awaits a JS promise, or any other value as Promise.resolve() does, and
+// resumes with the fulfilled value converted by TypeConvertor<T>, or with
+// nothing if T is void. The task is rejected if the promise is rejected or
+// the value isn't convertible. Await() takes a value made after the last
+// suspension, such as a result of a JS call. Otherwise use PromiseRef<T>.
+template <typename T>
+class PromiseAwaiter : public internal::TaskAwaiter,
+                       public internal::AwaitedValue<T> {
+ public:
+  explicit PromiseAwaiter(Napi::Value promise) : promise_(promise) {}
+
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) {
+    if (!Suspend(handle)) return;
+
+    Napi::Env env(this->env());
+    Napi::Object promise_class =
+        env.Global().Get("Promise").template As<Napi::Object>();
+    Napi::Value resolved =
+        promise_class.Get("resolve").template As<Napi::Function>().Call(
+            promise_class, {promise_});
+    napi_value on_fulfilled;
+    napi_value on_rejected;
+    napi_create_function(env, nullptr, 0, &OnFulfilled, this, &on_fulfilled);
+    napi_create_function(env, nullptr, 0, &OnRejected, this, &on_rejected);
+    if (!env.IsExceptionPending()) {
+      Napi::Object object = resolved.template As<Napi::Object>();
+      object.Get("then").template As<Napi::Function>().Call(
+          object, {on_fulfilled, on_rejected});
+    }
+    napi_value error;
+    if (napi_get_and_clear_last_exception(env, &error) == napi_ok &&
+        !Napi::Value(env, error).IsUndefined()) {
+      Reject(error);
+    }
+  }
+
+ private:
+  static PromiseAwaiter* GetAwaiter(napi_env env, napi_callback_info cbinfo,
+                                    napi_value* arg) {
+    size_t argc = 1;
+    void* data;
+    napi_get_cb_info(env, cbinfo, &argc, arg, nullptr, &data);
+    if (argc == 0) napi_get_undefined(env, arg);
+    return static_cast<PromiseAwaiter*>(data);
+  }
+
+  static napi_value OnFulfilled(napi_env env, napi_callback_info cbinfo) {
+    napi_value arg;
+    PromiseAwaiter* awaiter = GetAwaiter(env, cbinfo, &arg);
+    if constexpr (!std::is_void<T>::value) {
+      Napi::Value value(env, arg);
+      if (!TypeConvertor<T>::IsConvertible(value)) {
+        awaiter->Reject(
+            Napi::TypeError::New(env, "Type of resolved value is mismatched")
+                .Value());
+        return nullptr;
+      }
+      awaiter->value_.emplace(TypeConvertor<T>::ToNativeValue(value));
+    }
+    awaiter->Resume();
+    return nullptr;
+  }
+
+  static napi_value OnRejected(napi_env env, napi_callback_info cbinfo) {
+    napi_value reason;
+    GetAwaiter(env, cbinfo, &reason)->Reject(reason);
+    return nullptr;
+  }
+
+  Napi::Value promise_;
+};
+
+template <typename T = void>
+PromiseAwaiter<T> Await(Napi::Value promise) {
+  return PromiseAwaiter<T>(promise);
+}
+
+// A JS value passed to a bound function to be awaited later. JS values of a
+// call, such as Napi::Value and FunctionRef, are valid only until the task
+// first suspends, while it holds a reference to Promise.resolve(value) until
+// it is destroyed.
+//
+//   Task<int> Add(PromiseRef<int> a, PromiseRef<int> b) {
+//     int x = co_await a;
+//     int y = co_await b;
+//     co_return x + y;
+//   }
+template <typename T = void>
+class PromiseRef {
+ public:
+  explicit PromiseRef(Napi::Object promise)
+      : promise_(Napi::Persistent(promise)) {}
+
+  PromiseAwaiter<T> operator co_await() const {
+    return PromiseAwaiter<T>(promise_.Value());
+  }
+
+ private:
+  Napi::ObjectReference promise_;
+};
+
+template <typename T>
+class TypeConvertor<PromiseRef<T>> {
+ public:
+  static PromiseRef<T> ToNativeValue(const Napi::Value& value) {
+    Napi::Env env = value.Env();
+    Napi::Object promise_class =
+        env.Global().Get("Promise").template As<Napi::Object>();
+    Napi::Value promise =
+        promise_class.Get("resolve").template As<Napi::Function>().Call(
+            promise_class, {value});
+    return PromiseRef<T>(promise.template As<Napi::Object>());
+  }
+
+  static bool IsConvertible(const Napi::Value& value) { return true; }
+};
+
+// Runs |work| on a thread of the libuv threadpool and resumes with its
+// result on the JS thread. |work| must not touch JS values.
+//
+//   Task<std::vector<uint8_t>> Compress(std::vector<uint8_t> data) {
+//     co_return co_await RunInBackground([&data]() { return Deflate(data); });
+//   }
+template <typename F>
+class BackgroundAwaiter
+    : public internal::TaskAwaiter,
+      public internal::AwaitedValue<std::invoke_result_t<F&>> {
+ public:
+  using Result = std::invoke_result_t<F&>;
+
+  explicit BackgroundAwaiter(F work) : work_(std::move(work)) {}
+
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) {
+    if (!Suspend(handle)) return;
+
+    napi_value resource_name;
+    napi_create_string_utf8(env(), "node_binding:RunInBackground",
+                            NAPI_AUTO_LENGTH, &resource_name);
+    if (napi_create_async_work(env(), nullptr, resource_name, &Execute,
+                               &Complete, this, &async_work_) != napi_ok ||
+        napi_queue_async_work(env(), async_work_) != napi_ok) {
+      Reject("Failed to queue the background work");
+    }
+  }
+
+ private:
+  static void Execute(napi_env env, void* data) {
+    NODE_BINDING_TRACE_SCOPE("RunInBackground");
+    BackgroundAwaiter* awaiter = static_cast<BackgroundAwaiter*>(data);
+    if constexpr (std::is_void<Result>::value) {
+      awaiter->work_();
+    } else {
+      awaiter->value_.emplace(awaiter->work_());
+    }
+  }
+
+  static void Complete(napi_env env, napi_status status, void* data) {
+    NODE_BINDING_TRACE_SCOPE("ResumeTask");
+    BackgroundAwaiter* awaiter = static_cast<BackgroundAwaiter*>(data);
+    napi_delete_async_work(env, awaiter->async_work_);
+    if (status != napi_ok) {
+      awaiter->Reject("The background work was cancelled");
+      return;
+    }
+    awaiter->Resume();
+  }
+
+  F work_;
+  napi_async_work async_work_ = nullptr;
+};
+
+template <typename F>
+BackgroundAwaiter<std::decay_t<F>> RunInBackground(F&& work) {
+  return BackgroundAwaiter<std::decay_t<F>>(std::forward<F>(work));
+}
+
+// Rejects the task with |reason| and destroys the coroutine, which is how a
+// task fails without C++ exceptions.
+//
+//   if (n < 0) co_await Reject(Napi::RangeError::New(env, "Negative"));
+class RejectAwaiter : public internal::TaskAwaiter {
+ public:
+  explicit RejectAwaiter(Napi::Value reason) : reason_(reason) {}
+
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) {
+    if (Suspend(handle)) Reject(reason_);
+  }
+
+  void await_resume() {}
+
+ private:
+  napi_value reason_;
+};
+
+inline RejectAwaiter Reject(Napi::Value reason) {
+  return RejectAwaiter(reason);
+}
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_COROUTINE_H_
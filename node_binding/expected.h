@@ -0,0 +1,299 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_EXPECTED_H_
+#define NODE_BINDING_EXPECTED_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "napi.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+// A way a bound call fails, with an error code and a message. It is defined
+// once as a constant, so failing doesn't format a message, and the lengths
+// of both strings are taken at compile time.
+//
+//   constexpr Failure kNotFound("ENOTFOUND", "Key is not found");
+//
+// Expected<T> refers to it, so it has to outlive calls, e.g. be static.
+class Failure {
+ public:
+  template <size_t N, size_t M>
+  constexpr Failure(const char (&code)[N], const char (&message)[M])
+      : code_(code),
+        code_length_(N - 1),
+        message_(message),
+        message_length_(M - 1) {}
+
+  Failure(const Failure& other) = delete;
+  Failure& operator=(const Failure& other) = delete;
+
+  constexpr const char* code() const { return code_; }
+  constexpr const char* message() const { return message_; }
+
+  // Returns a new Error whose code property is |code()|, or an empty value
+  // if it fails.
+  Napi::Value NewError(Napi::Env env) const {
+    napi_value code;
+    napi_value message;
+    napi_value error;
+    if (napi_create_string_utf8(env, code_, code_length_, &code) != napi_ok ||
+        napi_create_string_utf8(env, message_, message_length_, &message) !=
+            napi_ok ||
+        napi_create_error(env, code, message, &error) != napi_ok) {
+      return Napi::Value();
+    }
+    return Napi::Value(env, error);
+  }
+
+ private:
+  const char* code_;
+  size_t code_length_;
+  const char* message_;
+  size_t message_length_;
+};
+
+// How a failed Expected<T> is returned to JS.
+enum class FailureMode {
+  // Throws a new Error, by napi_throw() rather than a C++ exception even
+  // with NAPI_CPP_EXCEPTIONS.
+  kThrow,
+  // Returns an Error as the result, which is created once per env and
+  // returned as is afterwards, so failing costs about as much as
+  // succeeding.
+  kReturn,
+};
+
+// The result of a bound function which fails by design, e.g. parsing or a
+// lookup, without C++ exceptions. It holds either a |T| or a Failure.
+//
+//   constexpr Failure kNotFound("ENOTFOUND", "Key is not found");
+//
+//   Expected<std::string> Lookup(const std::string& key) {
+//     auto it = table.find(key);
+//     if (it == table.end()) return kNotFound;
+//     return it->second;
+//   }
+template <typename T, FailureMode Mode = FailureMode::kThrow>
+class Expected {
+ public:
+  template <typename U,
+            typename = std::enable_if_t<
+                std::is_constructible<T, U&&>::value &&
+                !std::is_same<std::decay_t<U>, Expected>::value &&
+                !std::is_same<std::decay_t<U>, Failure>::value>>
+  Expected(U&& value) : failure_(nullptr) {
+    new (&value_) T(std::forward<U>(value));
+  }
+  Expected(const Failure& failure) : failure_(&failure) {}
+  // A Failure is referred to, so a temporary one would dangle.
+  Expected(const Failure&& failure) = delete;
+
+  Expected(const Expected& other) : failure_(other.failure_) {
+    if (ok()) new (&value_) T(other.value_);
+  }
+
+  Expected(Expected&& other) : failure_(other.failure_) {
+    if (ok()) new (&value_) T(std::move(other.value_));
+  }
+
+  Expected& operator=(const Expected& other) {
+    if (this != &other) {
+      this->~Expected();
+      new (this) Expected(other);
+    }
+    return *this;
+  }
+
+  Expected& operator=(Expected&& other) {
+    if (this != &other) {
+      this->~Expected();
+      new (this) Expected(std::move(other));
+    }
+    return *this;
+  }
+
+  ~Expected() {
+    if (ok()) value_.~T();
+  }
+
+  bool ok() const { return failure_ == nullptr; }
+  explicit operator bool() const { return ok(); }
+
+  // Only valid if !ok().
+  const Failure& failure() const { return *failure_; }
+
+  // Only valid if ok().
+  T& value() & { return value_; }
+  const T& value() const& { return value_; }
+  T&& value() && { return std::move(value_); }
+
+ private:
+  const Failure* failure_;
+  union {
+    T value_;
+  };
+};
+
+template <FailureMode Mode>
+class Expected<void, Mode> {
+ public:
+  Expected() : failure_(nullptr) {}
+  Expected(const Failure& failure) : failure_(&failure) {}
+  Expected(const Failure&& failure) = delete;
+
+  bool ok() const { return failure_ == nullptr; }
+  explicit operator bool() const { return ok(); }
+
+  const Failure& failure() const { return *failure_; }
+
+ private:
+  const Failure* failure_;
+};
+
+// An Expected<T> returning its failure to JS as an Error value instead of
+// throwing it.
+//
+//   const value = binding.tryParse(text);
+//   if (value instanceof Error) ...
+template <typename T>
+using Result = Expected<T, FailureMode::kReturn>;
+
+namespace internal {
+
+// Error values of failures, created once per env. An env runs on a single
+// thread, so they are kept per thread without a lock.
+class FailureValues {
+ public:
+  static Napi::Value Get(Napi::Env env, const Failure& failure) {
+    Key key = {env, &failure};
+    auto it = values().find(key);
+    if (it != values().end()) {
+      napi_value value;
+      napi_get_reference_value(env, it->second, &value);
+      return Napi::Value(env, value);
+    }
+
+    Napi::Value value = failure.NewError(env);
+    napi_ref ref;
+    if (value.IsEmpty() ||
+        napi_create_reference(env, value, 1, &ref) != napi_ok) {
+      return Napi::Value();
+    }
+    values()[key] = ref;
+    napi_add_env_cleanup_hook(env, &Cleanup, new Key(key));
+    return value;
+  }
+
+ private:
+  struct Key {
+    napi_env env;
+    const Failure* failure;
+
+    bool operator==(const Key& other) const {
+      return env == other.env && failure == other.failure;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return std::hash<const void*>()(key.env) * 31 +
+             std::hash<const void*>()(key.failure);
+    }
+  };
+
+  static std::unordered_map<Key, napi_ref, KeyHash>& values() {
+    static thread_local std::unordered_map<Key, napi_ref, KeyHash> values;
+    return values;
+  }
+
+  static void Cleanup(void* arg) {
+    Key* key = static_cast<Key*>(arg);
+    auto it = values().find(*key);
+    if (it != values().end()) {
+      napi_delete_reference(key->env, it->second);
+      values().erase(it);
+    }
+    delete key;
+  }
+};
+
+inline Napi::Value Fail(
+    Napi::Env env, const Failure& failure,
+    std::integral_constant<FailureMode, FailureMode::kThrow> mode) {
+  Napi::Value error = failure.NewError(env);
+  if (!error.IsEmpty()) napi_throw(env, error);
+  return env.Undefined();
+}
+
+inline Napi::Value Fail(
+    Napi::Env env, const Failure& failure,
+    std::integral_constant<FailureMode, FailureMode::kReturn> mode) {
+  return FailureValues::Get(env, failure);
+}
+
+}  // namespace internal
+
+template <typename T, FailureMode Mode>
+class TypeConvertor<Expected<T, Mode>> {
+ public:
+  // Only available if TypeConvertor<T> can convert without
+  // Napi::CallbackInfo.
+  template <typename U = T>
+  static std::enable_if_t<internal::HasEnvToJSValue<U>::value, Napi::Value>
+  ToJSValue(Napi::Env env, const Expected<T, Mode>& value) {
+    if (!value) return internal::Fail(env, value.failure(), FailureTag());
+    return TypeConvertor<T>::ToJSValue(env, value.value());
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Expected<T, Mode>& value) {
+    if (!value) {
+      return internal::Fail(info.Env(), value.failure(), FailureTag());
+    }
+    return TypeConvertor<T>::ToJSValue(info, value.value());
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               Expected<T, Mode>&& value) {
+    if (!value) {
+      return internal::Fail(info.Env(), value.failure(), FailureTag());
+    }
+    return TypeConvertor<T>::ToJSValue(info, std::move(value).value());
+  }
+
+ private:
+  using FailureTag = std::integral_constant<FailureMode, Mode>;
+};
+
+// Returns undefined on success.
+template <FailureMode Mode>
+class TypeConvertor<Expected<void, Mode>> {
+ public:
+  static Napi::Value ToJSValue(Napi::Env env,
+                               const Expected<void, Mode>& value) {
+    if (!value) {
+      return internal::Fail(env, value.failure(),
+                            std::integral_constant<FailureMode, Mode>());
+    }
+    return env.Undefined();
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Expected<void, Mode>& value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_EXPECTED_H_
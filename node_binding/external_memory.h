@@ -0,0 +1,230 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_EXTERNAL_MEMORY_H_
+#define NODE_BINDING_EXTERNAL_MEMORY_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "napi.h"
+
+namespace node_binding {
+
+// Returns the number of bytes |value| owns outside of itself. Specialize it
+// for a native class to report its memory to the JS engine when it is bound
+// by Class<T>, or when it is tracked by ExternalMemory.
+//
+//   template <>
+//   class ExternalMemorySize<Image> {
+//    public:
+//     static size_t Get(const Image& value) {
+//       return ExternalMemorySize<std::vector<uint8_t>>::Get(value.pixels);
+//     }
+//   };
+template <typename T, typename SFINAE = void>
+class ExternalMemorySize {};
+
+template <typename T, typename SFINAE = void>
+struct HasExternalMemorySize : std::false_type {};
+
+template <typename T>
+struct HasExternalMemorySize<
+    T, decltype((void)ExternalMemorySize<T>::Get(std::declval<const T&>()))>
+    : std::true_type {};
+
+// Returns ExternalMemorySize<T>::Get(value), or 0 if it isn't specialized.
+template <typename T>
+std::enable_if_t<HasExternalMemorySize<T>::value, size_t> ExternalMemorySizeOf(
+    const T& value) {
+  return ExternalMemorySize<T>::Get(value);
+}
+
+template <typename T>
+std::enable_if_t<!HasExternalMemorySize<T>::value, size_t>
+ExternalMemorySizeOf(const T& value) {
+  return 0;
+}
+
+template <typename T, typename Allocator>
+class ExternalMemorySize<std::vector<T, Allocator>> {
+ public:
+  static size_t Get(const std::vector<T, Allocator>& value) {
+    size_t size = value.capacity() * sizeof(T);
+    if (HasExternalMemorySize<T>::value) {
+      for (const T& element : value) {
+        size += ExternalMemorySizeOf(element);
+      }
+    }
+    return size;
+  }
+};
+
+template <typename CharT, typename Traits, typename Allocator>
+class ExternalMemorySize<std::basic_string<CharT, Traits, Allocator>> {
+ public:
+  static size_t Get(const std::basic_string<CharT, Traits, Allocator>& value) {
+    // Short strings are stored inline.
+    const CharT* begin = reinterpret_cast<const CharT*>(&value);
+    const CharT* end = reinterpret_cast<const CharT*>(&value + 1);
+    if (value.data() >= begin && value.data() < end) return 0;
+    return (value.capacity() + 1) * sizeof(CharT);
+  }
+};
+
+template <typename T, typename Deleter>
+class ExternalMemorySize<std::unique_ptr<T, Deleter>> {
+ public:
+  static size_t Get(const std::unique_ptr<T, Deleter>& value) {
+    if (!value) return 0;
+    return sizeof(T) + ExternalMemorySizeOf(*value);
+  }
+};
+
+// Counts bytes allocated through TrackingAllocator. It can back an
+// ExternalMemorySize<T> specialization of a type, whose allocations are
+// hard to walk.
+class AllocationCounter {
+ public:
+  size_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  void Add(size_t bytes) { bytes_.fetch_add(bytes, std::memory_order_relaxed); }
+
+  void Subtract(size_t bytes) {
+    bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<size_t> bytes_{0};
+};
+
+// An allocator counting its bytes to an AllocationCounter.
+//
+//   AllocationCounter counter;
+//   std::map<int, Node, std::less<int>,
+//            TrackingAllocator<std::pair<const int, Node>>>
+//       nodes(TrackingAllocator<std::pair<const int, Node>>(&counter));
+template <typename T>
+class TrackingAllocator {
+ public:
+  typedef T value_type;
+
+  explicit TrackingAllocator(AllocationCounter* counter) : counter_(counter) {}
+
+  template <typename U>
+  TrackingAllocator(const TrackingAllocator<U>& other)
+      : counter_(other.counter()) {}
+
+  T* allocate(size_t n) {
+    counter_->Add(n * sizeof(T));
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) {
+    counter_->Subtract(n * sizeof(T));
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  AllocationCounter* counter() const { return counter_; }
+
+ private:
+  AllocationCounter* counter_;
+};
+
+template <typename T, typename U>
+bool operator==(const TrackingAllocator<T>& a, const TrackingAllocator<U>& b) {
+  return a.counter() == b.counter();
+}
+
+template <typename T, typename U>
+bool operator!=(const TrackingAllocator<T>& a, const TrackingAllocator<U>& b) {
+  return a.counter() != b.counter();
+}
+
+// Reports native memory to the JS engine, so that the GC takes it into
+// account, and un-reports it when destroyed. Keep it next to the native
+// object in an ObjectWrap, and call Update() when its size changes.
+//
+//   class ImageJs : public Napi::ObjectWrap<ImageJs> {
+//    private:
+//     Image image_;
+//     ExternalMemory external_memory_;
+//   };
+//
+//   external_memory_.Update(env, ExternalMemorySizeOf(image_));
+class ExternalMemory {
+ public:
+  ExternalMemory() = default;
+  ExternalMemory(const ExternalMemory& other) = delete;
+  ExternalMemory& operator=(const ExternalMemory& other) = delete;
+
+  // The env must be alive, which holds in finalizers of the env.
+  ~ExternalMemory() { Update(env_, 0); }
+
+  size_t size() const { return size_; }
+
+  void Update(napi_env env, size_t size) {
+    if (size == size_) return;
+    int64_t change = static_cast<int64_t>(size) - static_cast<int64_t>(size_);
+    int64_t adjusted;
+    napi_adjust_external_memory(env, change, &adjusted);
+    env_ = env;
+    size_ = size;
+  }
+
+ private:
+  napi_env env_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Creates an ArrayBuffer owning |data| without copying. Its size is
+// accounted until the ArrayBuffer is collected. Newer JS engines account
+// external backing stores by themselves, so it is reported by ExternalMemory
+// only when the engine doesn't.
+template <typename T>
+Napi::ArrayBuffer NewExternalArrayBuffer(Napi::Env env,
+                                         std::vector<T>&& data) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "ArrayBuffer can only hold trivially copyable types.");
+  if (data.empty()) return Napi::ArrayBuffer::New(env, 0);
+
+  struct Holder {
+    std::vector<T> data;
+    ExternalMemory external_memory;
+  };
+  Holder* holder = new Holder{std::move(data), {}};
+  size_t byte_length = holder->data.size() * sizeof(T);
+
+  int64_t before;
+  napi_adjust_external_memory(env, 0, &before);
+  napi_value value;
+  napi_status status = napi_create_external_arraybuffer(
+      env, holder->data.data(), byte_length,
+      [](napi_env env, void* data, void* hint) {
+        delete static_cast<Holder*>(hint);
+      },
+      holder, &value);
+  if (status != napi_ok) {
+    delete holder;
+    Napi::Error::New(env).ThrowAsJavaScriptException();
+    return Napi::ArrayBuffer();
+  }
+  int64_t after;
+  napi_adjust_external_memory(env, 0, &after);
+
+  if (after - before < static_cast<int64_t>(byte_length)) {
+    holder->external_memory.Update(env, ExternalMemorySizeOf(holder->data));
+  }
+  return Napi::ArrayBuffer(env, value);
+}
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_EXTERNAL_MEMORY_H_
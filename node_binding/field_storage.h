@@ -0,0 +1,148 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_FIELD_STORAGE_H_
+#define NODE_BINDING_FIELD_STORAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "napi.h"
+#include "node_binding/lazy_export.h"
+
+namespace node_binding {
+
+// Where a native object of a Class<T> lives, and how its fields are
+// accessed.
+enum class Storage {
+  // |T| is allocated by Constructor<T>::CallNew, and every field is accessed
+  // by a native callback.
+  kNative,
+  // |T| lives in an ArrayBuffer held by its JS object. Fields of numbers and
+  // bool are accessed by JS accessors through a DataView at fixed offsets,
+  // without calling into native code, while methods run natively on the
+  // same memory. |T| has to be trivially copyable.
+  kArrayBuffer,
+};
+
+// Specialize it to keep a class bound by Class<T> in an ArrayBuffer.
+//
+//   template <>
+//   struct StoragePolicy<Particle> {
+//     static constexpr Storage value = Storage::kArrayBuffer;
+//   };
+template <typename T, typename SFINAE = void>
+struct StoragePolicy {
+  static constexpr Storage value = Storage::kNative;
+};
+
+namespace internal {
+
+// Returns the DataView accessor type of a field of |M|, e.g. "Float64" for
+// getFloat64(), or nullptr if |M| isn't accessed through a DataView. 64-bit
+// integers aren't, since they would be read as BigInt.
+template <typename M>
+constexpr const char* DataViewTypeOf() {
+  if (std::is_same<M, bool>::value) return "Uint8";
+  if (std::is_same<M, float>::value) return "Float32";
+  if (std::is_same<M, double>::value) return "Float64";
+  if (!std::is_integral<M>::value) return nullptr;
+  switch (sizeof(M)) {
+    case 1:
+      return std::is_signed<M>::value ? "Int8" : "Uint8";
+    case 2:
+      return std::is_signed<M>::value ? "Int16" : "Uint16";
+    case 4:
+      return std::is_signed<M>::value ? "Int32" : "Uint32";
+  }
+  return nullptr;
+}
+
+// A field of |T| accessed through a DataView.
+struct BufferField {
+  const char* name;
+  size_t offset;
+  const char* type;
+  bool is_bool;
+  bool writable;
+};
+
+template <typename T, typename M>
+size_t OffsetOf(M T::*member) {
+  // |T| is trivially copyable, so its members are addressed in raw storage
+  // without constructing it.
+  alignas(T) char storage[sizeof(T)];
+  const T* object = reinterpret_cast<const T*>(storage);
+  return reinterpret_cast<const char*>(&(object->*member)) - storage;
+}
+
+inline bool IsLittleEndian() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+// Returns the source of a function, which defines accessors of |fields| on
+// a prototype, and returns a function keeping the DataView of an object in
+// it. The DataView is kept in a private field, which only the accessors can
+// read, so that JS can't reach the buffer, e.g. to transfer it away from
+// native methods. Each accessor reads the DataView at a constant offset, so
+// that it is inlined like a plain property access.
+inline std::string BufferFieldsSource(const std::vector<BufferField>& fields) {
+  const std::string le = IsLittleEndian() ? "true" : "false";
+  std::string source =
+      "(function(prototype) {\n"
+      "  'use strict';\n"
+      "  // Returns the object to construct, so that #view is added to it.\n"
+      "  class Storage extends function(object) { return object; } {\n"
+      "    #view;\n"
+      "    constructor(object, view) {\n"
+      "      super(object);\n"
+      "      this.#view = view;\n"
+      "    }\n"
+      "    static define() {\n"
+      "      Object.defineProperties(prototype, {\n";
+  for (const BufferField& field : fields) {
+    std::string at = std::to_string(field.offset);
+    std::string get = "this.#view.get" + std::string(field.type) + "(" + at;
+    std::string set = "this.#view.set" + std::string(field.type) + "(" + at;
+    if (field.is_bool) {
+      get += ") !== 0";
+      set += ", v ? 1 : 0)";
+    } else {
+      get += ", " + le + ")";
+      set += ", v, " + le + ")";
+    }
+    source += "        " + QuoteJS(field.name) + ": {\n" +
+              "          get() { return " + get + "; },\n";
+    if (field.writable) {
+      source += std::string("          set(v) {\n") +
+                "            if (typeof v !== '" +
+                (field.is_bool ? "boolean" : "number") + "') {\n" +
+                "              throw new TypeError('Type of value is "
+                "mismatched');\n"
+                "            }\n" +
+                "            " + set + ";\n" +
+                "          },\n";
+    }
+    source += "        },\n";
+  }
+  source +=
+      "      });\n"
+      "    }\n"
+      "  }\n"
+      "  Storage.define();\n"
+      "  return (object, view) => { new Storage(object, view); };\n"
+      "})";
+  return source;
+}
+
+}  // namespace internal
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_FIELD_STORAGE_H_
@@ -0,0 +1,216 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_FUNCTION_H_
+#define NODE_BINDING_FUNCTION_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "napi.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+namespace internal {
+
+// Primitive results are checked by the status of their getters, which
+// saves a napi_typeof() per call.
+inline napi_status GetPrimitive(napi_env env, napi_value value, bool* result) {
+  return napi_get_value_bool(env, value, result);
+}
+
+inline napi_status GetPrimitive(napi_env env, napi_value value,
+                                int32_t* result) {
+  return napi_get_value_int32(env, value, result);
+}
+
+inline napi_status GetPrimitive(napi_env env, napi_value value,
+                                uint32_t* result) {
+  return napi_get_value_uint32(env, value, result);
+}
+
+inline napi_status GetPrimitive(napi_env env, napi_value value,
+                                double* result) {
+  return napi_get_value_double(env, value, result);
+}
+
+template <typename R, typename SFINAE = void>
+struct IsPrimitiveResult : std::false_type {};
+
+template <typename R>
+struct IsPrimitiveResult<R, decltype((void)GetPrimitive(
+                                nullptr, nullptr, std::declval<R*>()))>
+    : std::true_type {};
+
+inline void ThrowResultTypeMismatch(napi_env env) {
+  Napi::TypeError::New(env, "Type of return value is mismatched")
+      .ThrowAsJavaScriptException();
+}
+
+template <typename R>
+std::enable_if_t<std::is_void<R>::value, R> FunctionResult(napi_env env,
+                                                           napi_value value) {}
+
+template <typename R>
+std::enable_if_t<IsPrimitiveResult<R>::value, R> FunctionResult(
+    napi_env env, napi_value value) {
+  R result;
+  if (GetPrimitive(env, value, &result) != napi_ok) {
+    ThrowResultTypeMismatch(env);
+    return R();
+  }
+  return result;
+}
+
+template <typename R>
+std::enable_if_t<!std::is_void<R>::value && !IsPrimitiveResult<R>::value, R>
+FunctionResult(napi_env env, napi_value value) {
+  Napi::Value result(env, value);
+  if (!TypeConvertor<std::decay_t<R>>::IsConvertible(result)) {
+    ThrowResultTypeMismatch(env);
+    return R();
+  }
+  return TypeConvertor<std::decay_t<R>>::ToNativeValue(result);
+}
+
+// Returns true if every one of |Args| can be converted without
+// Napi::CallbackInfo, since a function may be called after the bound call.
+template <typename... Args>
+constexpr bool HasEnvToJSValues() {
+  const bool values[] = {true, HasEnvToJSValue<std::decay_t<Args>>::value...};
+  for (bool value : values) {
+    if (!value) return false;
+  }
+  return true;
+}
+
+// Calls the function returned by |get_function| with |args| converted into
+// |argv|, which is storage of the caller reused across calls. Handles made
+// for a call, including the function, are released when it returns. If the
+// call throws, the exception is left pending and R() is returned. Later
+// calls return R() without calling the function, since napi_call_function()
+// fails while an exception is pending.
+template <typename R, typename GetFunction, typename... Args>
+R CallFunction(napi_env env, GetFunction&& get_function, napi_value* argv,
+               Args&&... args) {
+  static_assert(HasEnvToJSValues<Args...>(),
+                "Arguments passed to JS functions need "
+                "TypeConvertor<T>::ToJSValue(Napi::Env, const T&).");
+  napi_handle_scope scope;
+  napi_open_handle_scope(env, &scope);
+
+  size_t i = 0;
+  int dummy[] = {0, (argv[i++] = TypeConvertor<std::decay_t<Args>>::ToJSValue(
+                         Napi::Env(env), std::forward<Args>(args)),
+                     0)...};
+  (void)dummy;
+
+  napi_value recv;
+  napi_get_undefined(env, &recv);
+  napi_value result;
+  napi_status status = napi_call_function(env, recv, get_function(),
+                                          sizeof...(Args), argv, &result);
+  if (status != napi_ok) {
+    napi_close_handle_scope(env, scope);
+    return R();
+  }
+
+  // The scope is closed by a guard, since R may be void.
+  struct ScopeGuard {
+    napi_env env;
+    napi_handle_scope scope;
+    ~ScopeGuard() { napi_close_handle_scope(env, scope); }
+  } guard{env, scope};
+  return FunctionResult<R>(env, result);
+}
+
+}  // namespace internal
+
+template <typename Signature>
+class FunctionRef;
+
+// A non-owning reference to a JS function passed as an argument, which is
+// callable as a native function. It is as cheap to copy as a pointer, so it
+// can be passed to algorithms by value. Arguments and the result are
+// converted by TypeConvertor, and the argv is kept inside instead of being
+// allocated per call. It is valid only during the bound call, since it
+// refers to the function by a local handle.
+//
+//   void Sort(std::vector<int>* values, FunctionRef<bool(int, int)> less) {
+//     std::sort(values->begin(), values->end(), less);
+//   }
+template <typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+ public:
+  FunctionRef(napi_env env, napi_value function)
+      : env_(env), function_(function) {}
+
+  R operator()(Args... args) const {
+    return internal::CallFunction<R>(
+        env_, [this]() { return function_; }, argv_,
+        std::forward<Args>(args)...);
+  }
+
+ private:
+  napi_env env_;
+  napi_value function_;
+  mutable napi_value argv_[sizeof...(Args) > 0 ? sizeof...(Args) : 1];
+};
+
+template <typename R, typename... Args>
+class TypeConvertor<FunctionRef<R(Args...)>> {
+ public:
+  static FunctionRef<R(Args...)> ToNativeValue(const Napi::Value& value) {
+    return FunctionRef<R(Args...)>(value.Env(), value);
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return value.IsFunction();
+  }
+};
+
+// Converts a JS function into a std::function, which holds a persistent
+// reference to it and may be kept after the bound call. It must be called
+// and destroyed on the JS thread.
+template <typename R, typename... Args>
+class TypeConvertor<std::function<R(Args...)>> {
+ public:
+  static std::function<R(Args...)> ToNativeValue(const Napi::Value& value) {
+    auto state = std::make_shared<State>(value.As<Napi::Function>());
+    return [state](Args... args) -> R {
+      const Napi::FunctionReference& function = state->function;
+      return internal::CallFunction<R>(
+          function.Env(), [&function]() { return function.Value(); },
+          state->argv, std::forward<Args>(args)...);
+    };
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return value.IsFunction();
+  }
+
+ private:
+  struct State {
+    explicit State(Napi::Function function)
+        : function(Napi::Persistent(function)) {}
+
+    Napi::FunctionReference function;
+    napi_value argv[sizeof...(Args) > 0 ? sizeof...(Args) : 1];
+  };
+};
+
+template <typename R, typename... Args>
+struct JSTypeOf<FunctionRef<R(Args...)>> : ExactJSTypes<napi_function> {};
+
+template <typename R, typename... Args>
+struct JSTypeOf<std::function<R(Args...)>> : ExactJSTypes<napi_function> {};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_FUNCTION_H_
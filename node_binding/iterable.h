@@ -0,0 +1,272 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_ITERABLE_H_
+#define NODE_BINDING_ITERABLE_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "napi.h"
+#include "node_binding/lazy_export.h"
+#include "node_binding/raw_call.h"
+#include "node_binding/trace.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+// A range of native elements, which is converted to a JS iterator instead of
+// an Array. Elements are converted on demand, in batches which start small
+// and double up to batch_size(), so that stopping early converts little and
+// iterating everything crosses into native code rarely.
+//
+//   Iterable<std::vector<Point>::const_iterator> Polygon::points() const {
+//     return MakeIterable(points_);
+//   }
+//
+//   for (const point of polygon.points()) { ... }
+//
+// The JS iterator keeps the owner of the range alive until it is exhausted
+// or closed, which is one of
+//
+//   - the receiver of the bound method returning it, if it is made from a
+//     range without an owner, so the range must live inside the receiver,
+//   - |owner|, a JS object the range lives inside, or
+//   - |keep_alive|, which is shared with the iterator, as MakeIterable() does
+//     for a shared_ptr or a moved container.
+//
+// Like a generator, the JS iterator can be iterated once. Elements are read
+// ahead of JS, so the range must not change meanwhile.
+template <typename Iterator>
+class Iterable {
+ public:
+  static constexpr size_t kDefaultBatchSize = 1024;
+
+  Iterable(Iterator begin, Iterator end)
+      : begin_(std::move(begin)), end_(std::move(end)) {}
+  Iterable(Iterator begin, Iterator end, Napi::Object owner)
+      : begin_(std::move(begin)), end_(std::move(end)), owner_(owner) {}
+  Iterable(Iterator begin, Iterator end, std::shared_ptr<const void> keep_alive)
+      : begin_(std::move(begin)),
+        end_(std::move(end)),
+        keep_alive_(std::move(keep_alive)) {}
+
+  const Iterator& begin() const { return begin_; }
+  const Iterator& end() const { return end_; }
+  const Napi::Object& owner() const { return owner_; }
+  const std::shared_ptr<const void>& keep_alive() const { return keep_alive_; }
+
+  // The most elements converted by one call into native code.
+  size_t batch_size() const { return batch_size_; }
+  Iterable& set_batch_size(size_t batch_size) {
+    batch_size_ = std::max(batch_size, static_cast<size_t>(1));
+    return *this;
+  }
+
+ private:
+  Iterator begin_;
+  Iterator end_;
+  Napi::Object owner_;
+  std::shared_ptr<const void> keep_alive_;
+  size_t batch_size_ = kDefaultBatchSize;
+};
+
+template <typename Container>
+Iterable<typename Container::const_iterator> MakeIterable(
+    const Container& container) {
+  return {container.begin(), container.end()};
+}
+
+// A temporary would be destroyed before the range is iterated.
+template <typename Container>
+void MakeIterable(const Container&& container) = delete;
+
+template <typename Container>
+Iterable<typename Container::const_iterator> MakeIterable(
+    const Container& container, Napi::Object owner) {
+  return {container.begin(), container.end(), owner};
+}
+
+template <typename Container>
+Iterable<typename Container::const_iterator> MakeIterable(
+    std::shared_ptr<const Container> container) {
+  const Container& ref = *container;
+  return {ref.begin(), ref.end(), std::move(container)};
+}
+
+template <typename Container>
+Iterable<typename Container::const_iterator> MakeIterable(
+    std::shared_ptr<Container> container) {
+  return MakeIterable(std::shared_ptr<const Container>(std::move(container)));
+}
+
+// Moves |container| into the iterator.
+template <typename Container>
+Iterable<typename Container::const_iterator> MakeOwnedIterable(
+    Container&& container) {
+  static_assert(!std::is_lvalue_reference<Container>::value,
+                "Use MakeIterable() to iterate a container in place.");
+  return MakeIterable(std::make_shared<const Container>(std::move(container)));
+}
+
+namespace internal {
+
+// Makes a JS iterator from fill(close), which returns the next batch of
+// elements, or an empty Array once exhausted. fill(true) releases the range
+// when the iterator is closed early, e.g. by break in for-of.
+constexpr const char kIterableFactorySource[] =
+    "(function(fill) {\n"
+    "  let batch = [];\n"
+    "  let index = 0;\n"
+    "  let done = false;\n"
+    "  return {\n"
+    "    [Symbol.iterator]() { return this; },\n"
+    "    next() {\n"
+    "      if (index == batch.length) {\n"
+    "        if (!done) {\n"
+    "          batch = fill(false);\n"
+    "          index = 0;\n"
+    "          done = batch.length == 0;\n"
+    "        }\n"
+    "        if (done) return {value: undefined, done: true};\n"
+    "      }\n"
+    "      return {value: batch[index++], done: false};\n"
+    "    },\n"
+    "    return(value) {\n"
+    "      if (!done) {\n"
+    "        done = true;\n"
+    "        batch = [];\n"
+    "        index = 0;\n"
+    "        fill(true);\n"
+    "      }\n"
+    "      return {value: value, done: true};\n"
+    "    },\n"
+    "  };\n"
+    "})";
+
+inline Napi::Value DefineIterableFactory(Napi::Env env) {
+  return RunScript(env, kIterableFactorySource);
+}
+
+// It is never destroyed, since cleanup hooks of envs refer to it.
+inline LazyExport& IterableFactory() {
+  static LazyExport* factory =
+      new LazyExport("Iterable", &DefineIterableFactory);
+  return *factory;
+}
+
+// The native side of a JS iterator, which is the data of its fill().
+template <typename Iterator>
+class IterableSource {
+ public:
+  IterableSource(Iterable<Iterator>&& iterable, Napi::Object owner)
+      : current_(iterable.begin()),
+        end_(iterable.end()),
+        keep_alive_(iterable.keep_alive()),
+        batch_size_(std::min(kMinBatchSize, iterable.batch_size())),
+        max_batch_size_(iterable.batch_size()) {
+    if (!owner.IsEmpty()) owner_ = Napi::Persistent(owner);
+  }
+
+  static napi_value Fill(napi_env env, napi_callback_info cbinfo) {
+    NODE_BINDING_TRACE_SCOPE("FillIterable");
+    size_t argc = 1;
+    napi_value close;
+    void* data;
+    napi_get_cb_info(env, cbinfo, &argc, &close, nullptr, &data);
+    IterableSource* source = static_cast<IterableSource*>(data);
+
+    bool closing = false;
+    if (argc == 1) napi_get_value_bool(env, close, &closing);
+    if (closing || source->released_) {
+      source->Release();
+      return Napi::Array::New(env);
+    }
+
+    size_t size = source->batch_size_;
+    source->batch_size_ = std::min(size * 2, source->max_batch_size_);
+
+    Napi::Array batch = Napi::Array::New(env);
+    for (uint32_t i = 0; i < size && source->current_ != source->end_;
+         ++i, ++source->current_) {
+      napi_value value = RawResult(env, cbinfo, *source->current_, 0);
+      if (value == nullptr || Napi::Env(env).IsExceptionPending()) {
+        return nullptr;
+      }
+      napi_set_element(env, batch, i, value);
+    }
+    // Releases the owner as soon as the range is exhausted, rather than
+    // when the iterator is collected.
+    if (source->current_ == source->end_) source->Release();
+    return batch;
+  }
+
+  static void Finalize(napi_env env, void* data, void* hint) {
+    delete static_cast<IterableSource*>(data);
+  }
+
+ private:
+  static constexpr size_t kMinBatchSize = 16;
+
+  void Release() {
+    if (released_) return;
+    released_ = true;
+    owner_.Reset();
+    keep_alive_.reset();
+  }
+
+  Iterator current_;
+  Iterator end_;
+  Napi::ObjectReference owner_;
+  std::shared_ptr<const void> keep_alive_;
+  size_t batch_size_;
+  size_t max_batch_size_;
+  bool released_ = false;
+};
+
+template <typename Iterator>
+constexpr size_t IterableSource<Iterator>::kMinBatchSize;
+
+}  // namespace internal
+
+template <typename Iterator>
+constexpr size_t Iterable<Iterator>::kDefaultBatchSize;
+
+// Only converted to JS, with the receiver of the call as the default owner.
+template <typename Iterator>
+class TypeConvertor<Iterable<Iterator>> {
+ public:
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               Iterable<Iterator> value) {
+    Napi::Env env = info.Env();
+    Napi::Value factory = internal::IterableFactory().Get(env);
+    if (factory.IsEmpty()) return Napi::Value();
+
+    Napi::Object owner = value.owner();
+    if (owner.IsEmpty() && !value.keep_alive() && info.This().IsObject()) {
+      owner = info.This().As<Napi::Object>();
+    }
+    using Source = internal::IterableSource<Iterator>;
+    Source* source = new Source(std::move(value), owner);
+
+    napi_value fill;
+    if (napi_create_function(env, "fill", NAPI_AUTO_LENGTH, &Source::Fill,
+                             source, &fill) != napi_ok ||
+        napi_wrap(env, fill, source, &Source::Finalize, nullptr, nullptr) !=
+            napi_ok) {
+      delete source;
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return Napi::Value();
+    }
+    return factory.As<Napi::Function>().Call({fill});
+  }
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_ITERABLE_H_
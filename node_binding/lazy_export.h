@@ -0,0 +1,155 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_LAZY_EXPORT_H_
+#define NODE_BINDING_LAZY_EXPORT_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "napi.h"
+
+namespace node_binding {
+
+// A value of an addon, such as a class or a function, which is defined on
+// first use instead of at require() time. The value is defined once per
+// env and kept until the env is torn down, so it works with worker threads.
+//
+//   LazyExport PointJs::class_("Point", &PointJs::Define);
+//
+//   void PointJs::Init(Napi::Env env, Napi::Object exports) {
+//     class_.Export(exports);
+//   }
+//
+// A LazyExport should be static, since getters and cleanup hooks refer to it.
+class LazyExport {
+ public:
+  typedef Napi::Value (*Definer)(Napi::Env env);
+
+  LazyExport(const char* name, Definer define)
+      : name_(name), define_(define) {}
+  LazyExport(const LazyExport& other) = delete;
+  LazyExport& operator=(const LazyExport& other) = delete;
+
+  const char* name() const { return name_; }
+
+  // Adds |name()| to |exports| as a getter. On first access, the getter
+  // calls Get() and replaces itself with the value.
+  void Export(Napi::Object exports) {
+    napi_property_descriptor desc = {
+        name_,   nullptr, nullptr, &Getter, nullptr, nullptr,
+        static_cast<napi_property_attributes>(napi_enumerable |
+                                              napi_configurable),
+        this};
+    napi_status status =
+        napi_define_properties(exports.Env(), exports, 1, &desc);
+    if (status != napi_ok) {
+      Napi::Error::New(exports.Env()).ThrowAsJavaScriptException();
+    }
+  }
+
+  // Returns the value for |env|, defining it on first call. Returns an empty
+  // value if the definition throws.
+  Napi::Value Get(Napi::Env env) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = values_.find(env);
+      if (it != values_.end()) return it->second.Value();
+    }
+
+    // |define_| is called without the lock, since it may get other values.
+    Napi::Value value = define_(env);
+    if (value.IsEmpty() || env.IsExceptionPending()) return Napi::Value();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Napi::Reference<Napi::Value>& ref = values_[env];
+    if (!ref.IsEmpty()) return ref.Value();
+    ref = Napi::Reference<Napi::Value>::New(value, 1);
+    ref.SuppressDestruct();
+    napi_add_env_cleanup_hook(env, &Cleanup, new CleanupData{this, env});
+    return value;
+  }
+
+  bool IsDefined(Napi::Env env) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return values_.find(env) != values_.end();
+  }
+
+ private:
+  struct CleanupData {
+    LazyExport* lazy_export;
+    napi_env env;
+  };
+
+  static napi_value Getter(napi_env env, napi_callback_info cbinfo) {
+    napi_value this_arg;
+    void* data;
+    napi_get_cb_info(env, cbinfo, nullptr, nullptr, &this_arg, &data);
+    LazyExport* lazy_export = static_cast<LazyExport*>(data);
+
+    Napi::Value value = lazy_export->Get(env);
+    if (value.IsEmpty()) return nullptr;
+
+    // Replaces the getter, so that later accesses are plain property loads.
+    // Deleting it first is much cheaper than reconfiguring it in place,
+    // which makes V8 rebuild the map of an object with many properties.
+    napi_value name = Napi::String::New(env, lazy_export->name_);
+    bool deleted;
+    napi_delete_property(env, this_arg, name, &deleted);
+    napi_set_property(env, this_arg, name, value);
+    return value;
+  }
+
+  static void Cleanup(void* arg) {
+    CleanupData* data = static_cast<CleanupData*>(arg);
+    LazyExport* lazy_export = data->lazy_export;
+    {
+      std::lock_guard<std::mutex> lock(lazy_export->mutex_);
+      auto it = lazy_export->values_.find(data->env);
+      if (it != lazy_export->values_.end()) {
+        it->second.Reset();
+        lazy_export->values_.erase(it);
+      }
+    }
+    delete data;
+  }
+
+  const char* name_;
+  Definer define_;
+  std::mutex mutex_;
+  std::unordered_map<napi_env, Napi::Reference<Napi::Value>> values_;
+};
+
+namespace internal {
+
+// Evaluates |source| in |env|, which defines JS helpers of a LazyExport.
+// Returns an empty value if it throws.
+inline Napi::Value RunScript(Napi::Env env, const char* source) {
+  napi_value result;
+  if (napi_run_script(env, Napi::String::New(env, source), &result) !=
+      napi_ok) {
+    if (!env.IsExceptionPending()) {
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+    }
+    return Napi::Value();
+  }
+  return Napi::Value(env, result);
+}
+
+// Returns |name| as a JS string literal, for generated sources.
+inline std::string QuoteJS(const char* name) {
+  std::string quoted = "\"";
+  for (const char* c = name; *c; ++c) {
+    if (*c == '"' || *c == '\\') quoted += '\\';
+    quoted += *c;
+  }
+  return quoted + "\"";
+}
+
+}  // namespace internal
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_LAZY_EXPORT_H_
@@ -8,6 +8,7 @@
 #include "napi.h"
 
 #include "node_binding/template_util.h"
+#include "node_binding/trace.h"
 #include "node_binding/type_convertor.h"
 
 #define THROW_JS_WRONG_NUMBER_OF_ARGUMENTS(env)            \
@@ -30,20 +31,35 @@
   if (env.IsExceptionPending()) return env.Null()
 #endif
 
+// Wraps a member pointer or a function pointer into a type, so that a
+// callback specialized for it can be generated at compile time.
+//
+//   Class<Point>("Point").Field("x", NODE_BINDING_MEMBER(&Point::x));
+#define NODE_BINDING_MEMBER(ptr) \
+  ::std::integral_constant<decltype(ptr), ptr>()
+
 #define RETURN_UNDEFINED_IF_FAILED_TO_CHECK_ARGS()                      \
+  NODE_BINDING_TRACE_CALL("TypedCall");                                 \
   ::Napi::Env env = info.Env();                                         \
   constexpr size_t num_args = sizeof...(Args) - sizeof...(DefaultArgs); \
   JS_CHECK_NUM_ARGS(info, num_args);                                    \
   RETURN_UNDEFINED_IF_HAS_PENDING_EXCEPTION(env);                       \
-  ::node_binding::ArgTypeChecker<Args...>::Check(info, 0, num_args);    \
-  RETURN_UNDEFINED_IF_HAS_PENDING_EXCEPTION(env)
+  ::node_binding::internal::PolicyArgSlots<Policy, Args...> arg_slots;  \
+  ::node_binding::ArgTypeChecker<Args...>::template Check<Policy>(      \
+      info, 0, num_args, &arg_slots);                                   \
+  RETURN_UNDEFINED_IF_HAS_PENDING_EXCEPTION(env);                       \
+  NODE_BINDING_TRACE_ARGS_CHECKED()
 
 #define RETURN_IF_FAILED_TO_CHECK_ARGS()                                \
+  NODE_BINDING_TRACE_CALL("TypedCall");                                 \
   ::Napi::Env env = info.Env();                                         \
   constexpr size_t num_args = sizeof...(Args) - sizeof...(DefaultArgs); \
   JS_CHECK_NUM_ARGS(info, num_args);                                    \
   RETURN_IF_HAS_PENDING_EXCEPTION(env);                                 \
-  ::node_binding::ArgTypeChecker<Args...>::Check(info, 0, num_args);    \
-  RETURN_IF_HAS_PENDING_EXCEPTION(env)
+  ::node_binding::internal::PolicyArgSlots<Policy, Args...> arg_slots;  \
+  ::node_binding::ArgTypeChecker<Args...>::template Check<Policy>(      \
+      info, 0, num_args, &arg_slots);                                   \
+  RETURN_IF_HAS_PENDING_EXCEPTION(env);                                 \
+  NODE_BINDING_TRACE_ARGS_CHECKED()
 
 #endif  // NODE_BINDING_MACROS_H_
\ No newline at end of file
@@ -0,0 +1,351 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_MAPPED_FILE_H_
+#define NODE_BINDING_MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "napi.h"
+#include "node_binding/span.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+// A file mapped into memory, or a range of it. Copies and slices share the
+// mapping, which is unmapped when the last of them is destroyed, including
+// ArrayBuffers made from them.
+//
+//   MappedFile file = MappedFile::Open("model.bin");
+//   MappedFile header = file.Slice(0, 64);
+//
+// A read-only file is mapped read-only, so that native readers of it always
+// see the file. ArrayBuffers can't be made read-only, so each ArrayBuffer
+// made from it gets a copy-on-write mapping of its own, which JS can write
+// without reaching the file, slices or other ArrayBuffers.
+class MappedFile {
+ public:
+  enum class Access {
+    kReadOnly,
+    kReadWrite,
+  };
+
+  MappedFile() = default;
+
+  // Returns an invalid MappedFile and sets |error| if it fails.
+  static MappedFile Open(const std::string& path,
+                         Access access = Access::kReadOnly,
+                         std::string* error = nullptr) {
+    std::shared_ptr<Mapping> mapping = Mapping::Open(path, access, error);
+    if (!mapping) return MappedFile();
+    uint8_t* data = mapping->data;
+    size_t size = mapping->size;
+    return MappedFile(std::move(mapping), data, size);
+  }
+
+  bool IsValid() const { return mapping_ != nullptr; }
+
+  uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  Access access() const { return mapping_->access; }
+
+  // Returns |length| bytes from |offset|, clamped to this range.
+  MappedFile Slice(size_t offset, size_t length) const {
+    offset = std::min(offset, size_);
+    length = std::min(length, size_ - offset);
+    return MappedFile(mapping_, data_ + offset, length);
+  }
+
+  Span<uint8_t> span() const { return Span<uint8_t>(data_, size_); }
+
+  // Returns this range mapped again copy-on-write, so that writes to it
+  // reach neither the file nor other mappings of it. Returns an invalid
+  // MappedFile if this is not a range of a read-only file, or if it fails.
+  MappedFile CopyOnWrite() const {
+    if (!IsValid() || mapping_->access != Access::kReadOnly) {
+      return MappedFile();
+    }
+    size_t offset = static_cast<size_t>(data_ - mapping_->data);
+    size_t skip = 0;
+    std::shared_ptr<Mapping> mapping =
+        mapping_->MapPrivate(offset, size_, &skip);
+    if (!mapping) return MappedFile();
+    uint8_t* data = mapping->data + skip;
+    return MappedFile(std::move(mapping), data, size_);
+  }
+
+ private:
+  struct Mapping {
+    static std::shared_ptr<Mapping> Open(const std::string& path,
+                                         Access access, std::string* error);
+    ~Mapping();
+
+    // Maps |length| bytes from |offset| of the file copy-on-write. The
+    // mapping starts at a boundary the platform allows, |skip| bytes before
+    // |offset|.
+    std::shared_ptr<Mapping> MapPrivate(size_t offset, size_t length,
+                                        size_t* skip) const;
+
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    Access access = Access::kReadOnly;
+    // The file of a read-only mapping, kept for MapPrivate().
+#if defined(_WIN32)
+    HANDLE handle = nullptr;
+#else
+    int fd = -1;
+#endif
+  };
+
+  MappedFile(std::shared_ptr<Mapping> mapping, uint8_t* data, size_t size)
+      : mapping_(std::move(mapping)), data_(data), size_(size) {}
+
+  std::shared_ptr<Mapping> mapping_;
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+#if defined(_WIN32)
+
+inline std::shared_ptr<MappedFile::Mapping> MappedFile::Mapping::Open(
+    const std::string& path, Access access, std::string* error) {
+  bool read_only = access == Access::kReadOnly;
+  HANDLE file = CreateFileA(
+      path.c_str(), read_only ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE,
+      FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    if (error) *error = "Failed to open " + path;
+    return nullptr;
+  }
+
+  auto mapping = std::make_shared<Mapping>();
+  mapping->access = access;
+  LARGE_INTEGER size;
+  GetFileSizeEx(file, &size);
+  mapping->size = static_cast<size_t>(size.QuadPart);
+  if (mapping->size > 0) {
+    HANDLE handle = CreateFileMappingA(
+        file, nullptr, read_only ? PAGE_READONLY : PAGE_READWRITE, 0, 0,
+        nullptr);
+    if (handle != nullptr) {
+      mapping->data = static_cast<uint8_t*>(MapViewOfFile(
+          handle, read_only ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, 0));
+      if (read_only && mapping->data != nullptr) {
+        mapping->handle = handle;
+      } else {
+        CloseHandle(handle);
+      }
+    }
+    if (mapping->data == nullptr) {
+      CloseHandle(file);
+      if (error) *error = "Failed to map " + path;
+      return nullptr;
+    }
+  }
+  CloseHandle(file);
+  return mapping;
+}
+
+inline std::shared_ptr<MappedFile::Mapping> MappedFile::Mapping::MapPrivate(
+    size_t offset, size_t length, size_t* skip) const {
+  if (handle == nullptr) return nullptr;
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  *skip = offset % info.dwAllocationGranularity;
+  uint64_t begin = offset - *skip;
+
+  auto mapping = std::make_shared<Mapping>();
+  mapping->access = Access::kReadWrite;
+  mapping->size = length + *skip;
+  mapping->data = static_cast<uint8_t*>(MapViewOfFile(
+      handle, FILE_MAP_COPY, static_cast<DWORD>(begin >> 32),
+      static_cast<DWORD>(begin), mapping->size));
+  if (mapping->data == nullptr) return nullptr;
+  return mapping;
+}
+
+inline MappedFile::Mapping::~Mapping() {
+  if (data) UnmapViewOfFile(data);
+  if (handle) CloseHandle(handle);
+}
+
+#else
+
+inline std::shared_ptr<MappedFile::Mapping> MappedFile::Mapping::Open(
+    const std::string& path, Access access, std::string* error) {
+  bool read_only = access == Access::kReadOnly;
+  int fd = open(path.c_str(), read_only ? O_RDONLY : O_RDWR);
+  if (fd < 0) {
+    if (error) *error = "Failed to open " + path + ": " + strerror(errno);
+    return nullptr;
+  }
+
+  auto mapping = std::make_shared<Mapping>();
+  mapping->access = access;
+  struct stat st;
+  if (fstat(fd, &st) == 0) mapping->size = static_cast<size_t>(st.st_size);
+  if (mapping->size > 0) {
+    void* data =
+        mmap(nullptr, mapping->size,
+             read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      if (error) *error = "Failed to map " + path + ": " + strerror(errno);
+      close(fd);
+      return nullptr;
+    }
+    mapping->data = static_cast<uint8_t*>(data);
+    if (read_only) {
+      mapping->fd = fd;
+      return mapping;
+    }
+  }
+  close(fd);
+  return mapping;
+}
+
+inline std::shared_ptr<MappedFile::Mapping> MappedFile::Mapping::MapPrivate(
+    size_t offset, size_t length, size_t* skip) const {
+  if (fd < 0) return nullptr;
+  *skip = offset % static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+  auto mapping = std::make_shared<Mapping>();
+  mapping->access = Access::kReadWrite;
+  void* data = mmap(nullptr, length + *skip, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE, fd, static_cast<off_t>(offset - *skip));
+  if (data == MAP_FAILED) return nullptr;
+  mapping->data = static_cast<uint8_t*>(data);
+  mapping->size = length + *skip;
+  return mapping;
+}
+
+inline MappedFile::Mapping::~Mapping() {
+  if (data) munmap(data, size);
+  if (fd >= 0) close(fd);
+}
+
+#endif
+
+// A MappedFile viewed as elements of T, which is converted to a TypedArray
+// of T.
+template <typename T>
+class MappedArray {
+ public:
+  explicit MappedArray(MappedFile file) : file_(std::move(file)) {}
+
+  const MappedFile& file() const { return file_; }
+
+  T* data() const { return reinterpret_cast<T*>(file_.data()); }
+  size_t size() const { return file_.size() / sizeof(T); }
+
+  Span<T> span() const { return Span<T>(data(), size()); }
+
+ private:
+  MappedFile file_;
+};
+
+namespace internal {
+
+// Creates an ArrayBuffer over |file| without copying, which keeps the
+// mapping until it is collected. A range of a read-only file is mapped
+// again copy-on-write for it. Mapped pages are backed by the file until
+// they are written, so they aren't reported as external memory.
+inline Napi::Value NewMappedArrayBuffer(Napi::Env env, const MappedFile& file) {
+  if (!file.IsValid()) return env.Null();
+  if (file.size() == 0) return Napi::ArrayBuffer::New(env, 0);
+
+  MappedFile* holder = new MappedFile(
+      file.access() == MappedFile::Access::kReadOnly ? file.CopyOnWrite()
+                                                     : file);
+  if (!holder->IsValid()) {
+    delete holder;
+    Napi::Error::New(env, "Failed to map the file copy-on-write")
+        .ThrowAsJavaScriptException();
+    return Napi::Value();
+  }
+  napi_value value;
+  napi_status status = napi_create_external_arraybuffer(
+      env, holder->data(), holder->size(),
+      [](napi_env env, void* data, void* hint) {
+        delete static_cast<MappedFile*>(hint);
+      },
+      holder, &value);
+  if (status != napi_ok) {
+    delete holder;
+    Napi::Error::New(env).ThrowAsJavaScriptException();
+    return Napi::Value();
+  }
+  return Napi::Value(env, value);
+}
+
+}  // namespace internal
+
+// Converts to an ArrayBuffer over the mapped range, or null if it is
+// invalid. To pass it back into a native function, take Span<uint8_t>.
+template <>
+class TypeConvertor<MappedFile> {
+ public:
+  static Napi::Value ToJSValue(Napi::Env env, const MappedFile& value) {
+    return internal::NewMappedArrayBuffer(env, value);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const MappedFile& value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+// Converts to a TypedArray of T over the mapped range, or null if it is
+// invalid. Throws a RangeError if the range isn't aligned to T. To pass it
+// back into a native function, take Span<T>.
+template <typename T>
+class TypeConvertor<MappedArray<T>> {
+ public:
+  static Napi::Value ToJSValue(Napi::Env env, const MappedArray<T>& value) {
+    const MappedFile& file = value.file();
+    if (reinterpret_cast<uintptr_t>(file.data()) % alignof(T) != 0 ||
+        file.size() % sizeof(T) != 0) {
+      Napi::RangeError::New(env, "Mapped range isn't aligned to the element")
+          .ThrowAsJavaScriptException();
+      return Napi::Value();
+    }
+    Napi::Value buffer = internal::NewMappedArrayBuffer(env, file);
+    if (buffer.IsEmpty() || buffer.IsNull()) return buffer;
+
+    napi_value array;
+    napi_status status =
+        napi_create_typedarray(env, TypedArrayTypeOf<T>::value, value.size(),
+                               buffer, 0, &array);
+    if (status != napi_ok) {
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return Napi::Value();
+    }
+    return Napi::Value(env, array);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const MappedArray<T>& value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_MAPPED_FILE_H_
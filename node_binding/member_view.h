@@ -0,0 +1,151 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_MEMBER_VIEW_H_
+#define NODE_BINDING_MEMBER_VIEW_H_
+
+#include <utility>
+
+#include "napi.h"
+
+namespace node_binding {
+
+namespace internal {
+
+// The member of a view NewMemberView() is constructing, which is passed to
+// the constructor in an external.
+struct MemberViewArgs {
+  void* member;
+};
+
+// Returns the MemberViewArgs of the view being constructed on this thread.
+// JS can pass any external to a constructor, so only the external made by
+// NewMemberView() is taken as a member.
+inline const MemberViewArgs*& PendingMemberView() {
+  thread_local const MemberViewArgs* pending = nullptr;
+  return pending;
+}
+
+}  // namespace internal
+
+// Native storage of an ObjectWrap, which either owns its value or aliases a
+// member of another wrapped object. While aliasing, it holds a strong
+// reference to the owner so that the member can't be freed under the view.
+//
+//   class PointJs : public Napi::ObjectWrap<PointJs> {
+//    private:
+//     ViewableValue<Point> point_;
+//   };
+template <typename T>
+class ViewableValue {
+ public:
+  ViewableValue() : ptr_(&value_) {}
+  ViewableValue(const ViewableValue& other) = delete;
+  ViewableValue& operator=(const ViewableValue& other) = delete;
+
+  ViewableValue& operator=(const T& value) {
+    *ptr_ = value;
+    return *this;
+  }
+
+  ViewableValue& operator=(T&& value) {
+    *ptr_ = std::move(value);
+    return *this;
+  }
+
+  // Makes this alias |member|, which lives inside |owner|.
+  void BindMemberView(T* member, Napi::Object owner) {
+    ptr_ = member;
+    owner_ = Napi::Persistent(owner);
+  }
+
+  // Binds to the member passed by NewMemberView(). |info| must satisfy
+  // IsMemberViewConstructCall().
+  void BindMemberView(const Napi::CallbackInfo& info) {
+    const internal::MemberViewArgs* args =
+        info[0].As<Napi::External<internal::MemberViewArgs>>().Data();
+    BindMemberView(static_cast<T*>(args->member), info[1].As<Napi::Object>());
+  }
+
+  bool is_member_view() const { return !owner_.IsEmpty(); }
+
+  T* get() { return ptr_; }
+  const T* get() const { return ptr_; }
+
+  T& operator*() { return *ptr_; }
+  const T& operator*() const { return *ptr_; }
+  T* operator->() { return ptr_; }
+  const T* operator->() const { return ptr_; }
+
+ private:
+  T value_;
+  T* ptr_;
+  Napi::ObjectReference owner_;
+};
+
+// Returns true if the constructor is called from NewMemberView(). A member
+// view is constructed with an external made by NewMemberView(), which JS
+// can't get.
+inline bool IsMemberViewConstructCall(const Napi::CallbackInfo& info) {
+  return info.Length() == 2 && info[0].IsExternal() && info[1].IsObject() &&
+         info[0].As<Napi::External<void>>().Data() ==
+             internal::PendingMemberView();
+}
+
+// Constructs a view of |member|, which lives inside |owner|, using
+// |constructor|. The constructor should call
+// ViewableValue<T>::BindMemberView(info) when IsMemberViewConstructCall()
+// returns true.
+template <typename T>
+Napi::Object NewMemberView(Napi::Function constructor, Napi::Object owner,
+                           T* member) {
+  Napi::Env env = owner.Env();
+  Napi::EscapableHandleScope scope(env);
+
+  internal::MemberViewArgs args = {member};
+  const internal::MemberViewArgs* outer = internal::PendingMemberView();
+  internal::PendingMemberView() = &args;
+  Napi::Object object = constructor.New({
+      Napi::External<internal::MemberViewArgs>::New(env, &args),
+      owner,
+  });
+  internal::PendingMemberView() = outer;
+
+  return scope.Escape(napi_value(object)).ToObject();
+}
+
+template <typename T>
+Napi::Object NewMemberView(const Napi::FunctionReference& constructor,
+                           Napi::Object owner, T* member) {
+  return NewMemberView(constructor.Value(), owner, member);
+}
+
+// Caches a member view for repeated reads. The cache only holds a weak
+// reference, since the view holds a strong reference to its owner.
+//
+//   Napi::Value RectJs::GetTopLeft(const Napi::CallbackInfo& info) {
+//     return top_left_view_.Get(
+//         [this]() { return PointJs::NewView(Value(), &rect_.top_left); });
+//   }
+class MemberViewCache {
+ public:
+  template <typename Factory>
+  Napi::Object Get(Factory&& new_view) {
+    if (!view_.IsEmpty()) {
+      Napi::Object view = view_.Value();
+      if (!view.IsEmpty()) return view;
+    }
+
+    Napi::Object view = new_view();
+    view_ = Napi::Weak(view);
+    return view;
+  }
+
+ private:
+  Napi::ObjectReference view_;
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_MEMBER_VIEW_H_
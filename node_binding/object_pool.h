@@ -0,0 +1,333 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_OBJECT_POOL_H_
+#define NODE_BINDING_OBJECT_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace node_binding {
+
+// How a native object made by Constructor<T>::CallNew is allocated.
+enum class Allocation {
+  // By operator new.
+  kHeap,
+  // From ObjectPool, so that objects created and collected at high rates
+  // reuse blocks instead of going through malloc.
+  kPooled,
+};
+
+// Specialize it to allocate a class bound by Class<T>, or constructed by
+// TypedConstruct(), from ObjectPool.
+//
+//   template <>
+//   struct AllocationPolicy<Particle> {
+//     static constexpr Allocation value = Allocation::kPooled;
+//   };
+template <typename T, typename SFINAE = void>
+struct AllocationPolicy {
+  static constexpr Allocation value = Allocation::kHeap;
+};
+
+// Blocks for small native objects, in size classes of kGranularity bytes.
+// Each thread allocates from and frees into its own cache of each size
+// class, which exchanges kBatchSize blocks at a time with a shared free
+// list, so most calls take no lock. A block may be freed on any thread, e.g.
+// the reclaimer thread. Blocks are carved out of chunks of kChunkSize bytes,
+// which are never returned to malloc.
+class ObjectPool {
+ public:
+  // Occupancy of a size class. Counts are taken without stopping other
+  // threads, so they are approximate while those allocate.
+  struct Stats {
+    size_t block_size;
+    // Number of blocks carved out of chunks, which is the sum of the
+    // following three.
+    size_t reserved;
+    // Number of blocks allocated and not freed yet.
+    size_t in_use;
+    // Number of free blocks in thread caches.
+    size_t cached;
+    // Number of free blocks in the shared free list.
+    size_t shared;
+    uint64_t allocated;
+    // Number of batches taken from or given back to the shared free list.
+    uint64_t exchanged;
+  };
+
+  static constexpr size_t kGranularity = 16;
+  static constexpr size_t kNumSizeClasses = 16;
+  // Larger objects are allocated by operator new.
+  static constexpr size_t kMaxBlockSize = kGranularity * kNumSizeClasses;
+  static constexpr size_t kBatchSize = 32;
+  static constexpr size_t kChunkSize = 16 * 1024;
+
+  static ObjectPool& GetInstance() {
+    // Leaked, since thread caches give blocks back to it when their threads
+    // exit, which may be after static destruction.
+    static ObjectPool* pool = new ObjectPool();
+    return *pool;
+  }
+
+  ObjectPool(const ObjectPool& other) = delete;
+  ObjectPool& operator=(const ObjectPool& other) = delete;
+
+  // Returns a block of at least |size| bytes, which is at most
+  // kMaxBlockSize, aligned to kGranularity.
+  void* Allocate(size_t size) {
+    size_t size_class = SizeClassOf(size);
+    Bin& bin = Cache().bins[size_class];
+    if (bin.head == nullptr) Refill(size_class, &bin);
+    FreeBlock* block = bin.head;
+    bin.head = block->next;
+    Add(&bin.count, -1);
+    Add(&bin.allocated, 1);
+    return block;
+  }
+
+  // Frees |block| of |size| bytes, allocated on any thread.
+  void Free(void* block, size_t size) {
+    size_t size_class = SizeClassOf(size);
+    Bin& bin = Cache().bins[size_class];
+    FreeBlock* free_block = static_cast<FreeBlock*>(block);
+    free_block->next = bin.head;
+    bin.head = free_block;
+    Add(&bin.count, 1);
+    Add(&bin.freed, 1);
+    if (bin.count.load(std::memory_order_relaxed) > 2 * kBatchSize) {
+      Drain(size_class, &bin, kBatchSize);
+    }
+  }
+
+  // Returns stats of size classes which have reserved blocks.
+  std::vector<Stats> stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Stats> stats;
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      const SharedList& shared = shared_[i];
+      if (shared.reserved == 0) continue;
+      Stats stat = {};
+      stat.block_size = BlockSize(i);
+      stat.reserved = shared.reserved;
+      stat.shared = shared.count;
+      stat.exchanged = shared.exchanged;
+      uint64_t allocated = shared.retired_allocated;
+      uint64_t freed = shared.retired_freed;
+      for (const ThreadCache* cache : caches_) {
+        const Bin& bin = cache->bins[i];
+        stat.cached += bin.count.load(std::memory_order_relaxed);
+        allocated += bin.allocated.load(std::memory_order_relaxed);
+        freed += bin.freed.load(std::memory_order_relaxed);
+      }
+      stat.allocated = allocated;
+      stat.in_use = static_cast<size_t>(allocated - freed);
+      stats.push_back(stat);
+    }
+    return stats;
+  }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  // Free blocks of a size class in a thread cache. Counters are written
+  // only by the owning thread, and read by stats().
+  struct Bin {
+    FreeBlock* head = nullptr;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> allocated{0};
+    std::atomic<uint64_t> freed{0};
+  };
+
+  struct SharedList {
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+    size_t reserved = 0;
+    uint64_t exchanged = 0;
+    // Counters of thread caches whose threads have exited.
+    uint64_t retired_allocated = 0;
+    uint64_t retired_freed = 0;
+  };
+
+  struct ThreadCache {
+    ThreadCache() { GetInstance().Register(this); }
+    ~ThreadCache() { GetInstance().Retire(this); }
+
+    Bin bins[kNumSizeClasses];
+  };
+
+  ObjectPool() = default;
+
+  static size_t SizeClassOf(size_t size) {
+    return (std::max<size_t>(size, 1) - 1) / kGranularity;
+  }
+
+  static size_t BlockSize(size_t size_class) {
+    return (size_class + 1) * kGranularity;
+  }
+
+  static ThreadCache& Cache() {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+
+  // Adds to a counter written only by the current thread.
+  template <typename T>
+  static void Add(std::atomic<T>* counter, int delta) {
+    counter->store(counter->load(std::memory_order_relaxed) + delta,
+                   std::memory_order_relaxed);
+  }
+
+  void Register(ThreadCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.push_back(cache);
+  }
+
+  void Retire(ThreadCache* cache) {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      Bin& bin = cache->bins[i];
+      Drain(i, &bin, bin.count.load(std::memory_order_relaxed));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      shared_[i].retired_allocated += cache->bins[i].allocated;
+      shared_[i].retired_freed += cache->bins[i].freed;
+    }
+    caches_.erase(std::find(caches_.begin(), caches_.end(), cache));
+  }
+
+  // Moves up to kBatchSize blocks from the shared free list to |bin|,
+  // carving a new chunk if it is empty.
+  void Refill(size_t size_class, Bin* bin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SharedList& shared = shared_[size_class];
+    if (shared.count == 0) {
+      size_t block_size = BlockSize(size_class);
+      size_t num_blocks = kChunkSize / block_size;
+      char* chunk = static_cast<char*>(::operator new(kChunkSize));
+      for (size_t i = num_blocks; i > 0; --i) {
+        FreeBlock* block =
+            reinterpret_cast<FreeBlock*>(chunk + (i - 1) * block_size);
+        block->next = shared.head;
+        shared.head = block;
+      }
+      shared.count += num_blocks;
+      shared.reserved += num_blocks;
+    }
+
+    size_t n = std::min(kBatchSize, shared.count);
+    for (size_t i = 0; i < n; ++i) {
+      FreeBlock* block = shared.head;
+      shared.head = block->next;
+      block->next = bin->head;
+      bin->head = block;
+    }
+    shared.count -= n;
+    ++shared.exchanged;
+    Add(&bin->count, static_cast<int>(n));
+  }
+
+  // Moves |n| blocks from |bin| to the shared free list.
+  void Drain(size_t size_class, Bin* bin, size_t n) {
+    if (n == 0) return;
+    FreeBlock* first = bin->head;
+    FreeBlock* last = first;
+    for (size_t i = 1; i < n; ++i) last = last->next;
+    bin->head = last->next;
+    Add(&bin->count, -static_cast<int>(n));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    SharedList& shared = shared_[size_class];
+    last->next = shared.head;
+    shared.head = first;
+    shared.count += n;
+    ++shared.exchanged;
+  }
+
+  std::mutex mutex_;
+  SharedList shared_[kNumSizeClasses];
+  std::vector<ThreadCache*> caches_;
+};
+
+namespace internal {
+
+template <typename T>
+struct IsPooled
+    : std::integral_constant<
+          bool, AllocationPolicy<T>::value == Allocation::kPooled &&
+                    sizeof(T) <= ObjectPool::kMaxBlockSize &&
+                    alignof(T) <= ObjectPool::kGranularity> {};
+
+template <typename T, typename... Args>
+T* NewNativeIn(std::false_type pooled, Args&&... args) {
+  return new T(std::forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+T* NewNativeIn(std::true_type pooled, Args&&... args) {
+  // Gives the block back if the constructor throws.
+  struct Block {
+    ~Block() {
+      if (data) ObjectPool::GetInstance().Free(data, sizeof(T));
+    }
+    void* data;
+  } block = {ObjectPool::GetInstance().Allocate(sizeof(T))};
+  T* native = new (block.data) T(std::forward<Args>(args)...);
+  block.data = nullptr;
+  return native;
+}
+
+// Creates a |T| as AllocationPolicy<T> says. Classes which are larger than
+// ObjectPool::kMaxBlockSize, or over-aligned, are allocated by operator new
+// even if pooled.
+template <typename T, typename... Args>
+T* NewNative(Args&&... args) {
+  return NewNativeIn<T>(IsPooled<T>(), std::forward<Args>(args)...);
+}
+
+template <typename T>
+void DeleteNativeIn(std::false_type pooled, T* native) {
+  delete native;
+}
+
+template <typename T>
+void DeleteNativeIn(std::true_type pooled, T* native) {
+  native->~T();
+  ObjectPool::GetInstance().Free(native, sizeof(T));
+}
+
+// Deletes |native| created by NewNative().
+template <typename T>
+void DeleteNative(T* native) {
+  if (native == nullptr) return;
+  DeleteNativeIn(IsPooled<T>(), native);
+}
+
+}  // namespace internal
+
+// A deleter of std::unique_ptr for an object created by
+// Constructor<T>::CallNew, which frees it as AllocationPolicy<T> says.
+//
+//   class ParticleJs : public Napi::ObjectWrap<ParticleJs> {
+//    private:
+//     std::unique_ptr<Particle, NativeDeleter<Particle>> particle_;
+//   };
+template <typename T>
+struct NativeDeleter {
+  void operator()(T* native) const { internal::DeleteNative(native); }
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_OBJECT_POOL_H_
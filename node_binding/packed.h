@@ -0,0 +1,668 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_PACKED_H_
+#define NODE_BINDING_PACKED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "napi.h"
+#include "node_binding/lazy_export.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+// The fields of a struct which can be Packed<T>. Specialize it with Fields(),
+// which returns a tuple of MakePackedField().
+//
+//   template <>
+//   struct PackedSchema<Point> {
+//     static auto Fields() {
+//       return std::make_tuple(MakePackedField("x", &Point::x),
+//                              MakePackedField("y", &Point::y));
+//     }
+//   };
+//
+// A field may be a number, bool, std::string, std::vector of those, or
+// another struct with a PackedSchema.
+template <typename T>
+struct PackedSchema;
+
+template <typename T, typename M>
+struct PackedField {
+  const char* name;
+  M T::*member;
+};
+
+template <typename T, typename M>
+constexpr PackedField<T, M> MakePackedField(const char* name, M T::*member) {
+  return {name, member};
+}
+
+// A value which crosses between native and JS as one ArrayBuffer, instead
+// of one N-API call per field. Its layout is derived from PackedSchema<T> at
+// compile time, and a JS codec generated from the same schema builds or
+// reads the JS object graph.
+//
+//   Packed<Scene> CLoadScene(const std::string& path);
+//   void CSaveScene(const Packed<Scene>& scene);
+template <typename T>
+class Packed {
+ public:
+  Packed() = default;
+  Packed(const T& value) : value_(value) {}
+  Packed(T&& value) : value_(std::move(value)) {}
+
+  T& value() { return value_; }
+  const T& value() const { return value_; }
+
+  T& operator*() { return value_; }
+  const T& operator*() const { return value_; }
+  T* operator->() { return &value_; }
+  const T* operator->() const { return &value_; }
+
+ private:
+  T value_;
+};
+
+namespace internal {
+
+// Reads packed bytes, failing instead of reading past the end.
+class PackedInput {
+ public:
+  PackedInput(const uint8_t* data, size_t size)
+      : p_(data), end_(data + size) {}
+
+  size_t remaining() const { return end_ - p_; }
+
+  bool Read(void* data, size_t size) {
+    if (remaining() < size) return false;
+    if (size > 0) memcpy(data, p_, size);
+    p_ += size;
+    return true;
+  }
+
+  bool ReadCount(uint32_t* count) { return Read(count, sizeof(*count)); }
+
+ private:
+  const uint8_t* p_;
+  const uint8_t* end_;
+};
+
+// Builds the JS codec of a Packed<T>. Each packed type gets a reader and a
+// writer function, which are shared by all fields of that type.
+class PackedCodeGen {
+ public:
+  // Names the reader or writer of T, which is |prefix| 'r' or 'w'. Returns
+  // false if it is already named. A name is given before its function is
+  // added, so that recursive types refer to it.
+  template <typename T>
+  bool Declare(char prefix, std::string* name) {
+    static char key;
+    auto it = names_.find({&key, prefix});
+    if (it != names_.end()) {
+      *name = it->second;
+      return false;
+    }
+    *name = prefix + std::to_string(names_.size());
+    names_.emplace(std::make_pair(&key, prefix), *name);
+    return true;
+  }
+
+  void Add(const std::string& function) { functions_ += function; }
+
+  const std::string& functions() const { return functions_; }
+
+ private:
+  std::map<std::pair<const void*, char>, std::string> names_;
+  std::string functions_;
+};
+
+template <typename T>
+struct PackedScalar;
+
+#define NODE_BINDING_PACKED_SCALAR(type, name) \
+  template <>                                  \
+  struct PackedScalar<type> {                  \
+    static const char* Name() { return name; } \
+  }
+
+NODE_BINDING_PACKED_SCALAR(int8_t, "i8");
+NODE_BINDING_PACKED_SCALAR(uint8_t, "u8");
+NODE_BINDING_PACKED_SCALAR(int16_t, "i16");
+NODE_BINDING_PACKED_SCALAR(uint16_t, "u16");
+NODE_BINDING_PACKED_SCALAR(int32_t, "i32");
+NODE_BINDING_PACKED_SCALAR(uint32_t, "u32");
+NODE_BINDING_PACKED_SCALAR(int64_t, "i64");
+NODE_BINDING_PACKED_SCALAR(uint64_t, "u64");
+NODE_BINDING_PACKED_SCALAR(float, "f32");
+NODE_BINDING_PACKED_SCALAR(double, "f64");
+
+#undef NODE_BINDING_PACKED_SCALAR
+
+template <typename T, typename SFINAE = void>
+struct HasPackedSchema : std::false_type {};
+
+template <typename T>
+struct HasPackedSchema<T, decltype(void(PackedSchema<T>::Fields()))>
+    : std::true_type {};
+
+// How a T is packed. Numbers are in the byte order of the host, counts are
+// uint32_t, and strings are UTF-8. There is no padding.
+template <typename T, typename SFINAE = void>
+struct PackedTraits;
+
+template <typename T>
+struct PackedTraits<T, decltype(void(PackedScalar<T>::Name()))> {
+  static size_t Size(const T& value) { return sizeof(T); }
+
+  static void Write(const T& value, uint8_t** p) {
+    memcpy(*p, &value, sizeof(T));
+    *p += sizeof(T);
+  }
+
+  static bool Read(PackedInput* in, T* out) {
+    return in->Read(out, sizeof(T));
+  }
+
+  static std::string Reader(PackedCodeGen* gen) {
+    return std::string("r_") + PackedScalar<T>::Name();
+  }
+
+  static std::string Writer(PackedCodeGen* gen) {
+    return std::string("w_") + PackedScalar<T>::Name();
+  }
+};
+
+template <>
+struct PackedTraits<bool> {
+  static size_t Size(bool value) { return 1; }
+
+  static void Write(bool value, uint8_t** p) { *(*p)++ = value ? 1 : 0; }
+
+  static bool Read(PackedInput* in, bool* out) {
+    uint8_t byte;
+    if (!in->Read(&byte, 1)) return false;
+    *out = byte != 0;
+    return true;
+  }
+
+  static std::string Reader(PackedCodeGen* gen) { return "r_bool"; }
+  static std::string Writer(PackedCodeGen* gen) { return "w_bool"; }
+};
+
+template <>
+struct PackedTraits<std::string> {
+  static size_t Size(const std::string& value) {
+    return sizeof(uint32_t) + value.size();
+  }
+
+  static void Write(const std::string& value, uint8_t** p) {
+    uint32_t size = static_cast<uint32_t>(value.size());
+    memcpy(*p, &size, sizeof(size));
+    if (size > 0) memcpy(*p + sizeof(size), value.data(), size);
+    *p += sizeof(size) + size;
+  }
+
+  static bool Read(PackedInput* in, std::string* out) {
+    uint32_t size;
+    if (!in->ReadCount(&size) || in->remaining() < size) return false;
+    out->resize(size);
+    return in->Read(&(*out)[0], size);
+  }
+
+  static std::string Reader(PackedCodeGen* gen) { return "r_str"; }
+  static std::string Writer(PackedCodeGen* gen) { return "w_str"; }
+};
+
+template <typename E>
+struct PackedTraits<std::vector<E>> {
+  // Numbers are copied as one block.
+  static constexpr bool kBlock =
+      std::is_arithmetic<E>::value && !std::is_same<E, bool>::value;
+
+  using Block = std::integral_constant<bool, kBlock>;
+
+  static size_t Size(const std::vector<E>& value) {
+    return sizeof(uint32_t) + ElementsSize(value, Block());
+  }
+
+  static void Write(const std::vector<E>& value, uint8_t** p) {
+    uint32_t count = static_cast<uint32_t>(value.size());
+    memcpy(*p, &count, sizeof(count));
+    *p += sizeof(count);
+    WriteElements(value, p, Block());
+  }
+
+  static bool Read(PackedInput* in, std::vector<E>* out) {
+    uint32_t count;
+    if (!in->ReadCount(&count)) return false;
+    return ReadElements(in, count, out, Block());
+  }
+
+  static std::string Reader(PackedCodeGen* gen) {
+    std::string name;
+    if (gen->Declare<std::vector<E>>('r', &name)) {
+      std::string element = PackedTraits<E>::Reader(gen);
+      gen->Add("function " + name + "() { return r_arr(" + element +
+               "); }\n");
+    }
+    return name;
+  }
+
+  static std::string Writer(PackedCodeGen* gen) {
+    std::string name;
+    if (gen->Declare<std::vector<E>>('w', &name)) {
+      std::string element = PackedTraits<E>::Writer(gen);
+      gen->Add("function " + name + "(x) { w_arr(" + element + ", x); }\n");
+    }
+    return name;
+  }
+
+ private:
+  static size_t ElementsSize(const std::vector<E>& value, std::true_type) {
+    return value.size() * sizeof(E);
+  }
+
+  static size_t ElementsSize(const std::vector<E>& value, std::false_type) {
+    size_t size = 0;
+    for (const auto& element : value) {
+      size += PackedTraits<E>::Size(element);
+    }
+    return size;
+  }
+
+  static void WriteElements(const std::vector<E>& value, uint8_t** p,
+                            std::true_type) {
+    if (value.empty()) return;
+    memcpy(*p, value.data(), value.size() * sizeof(E));
+    *p += value.size() * sizeof(E);
+  }
+
+  static void WriteElements(const std::vector<E>& value, uint8_t** p,
+                            std::false_type) {
+    for (const auto& element : value) PackedTraits<E>::Write(element, p);
+  }
+
+  static bool ReadElements(PackedInput* in, uint32_t count,
+                           std::vector<E>* out, std::true_type) {
+    if (in->remaining() / sizeof(E) < count) return false;
+    out->resize(count);
+    return in->Read(out->data(), count * sizeof(E));
+  }
+
+  static bool ReadElements(PackedInput* in, uint32_t count,
+                           std::vector<E>* out, std::false_type) {
+    out->clear();
+    // Each element takes a byte at least, unless it is an empty struct, so
+    // a bogus count can't reserve much.
+    out->reserve(std::min<size_t>(count, in->remaining()));
+    for (uint32_t i = 0; i < count; ++i) {
+      E element;
+      if (!PackedTraits<E>::Read(in, &element)) return false;
+      out->push_back(std::move(element));
+    }
+    return true;
+  }
+};
+
+template <typename T>
+struct PackedTraits<T, std::enable_if_t<HasPackedSchema<T>::value>> {
+  using Fields = decltype(PackedSchema<T>::Fields());
+  using Indices = std::make_index_sequence<std::tuple_size<Fields>::value>;
+
+  static size_t Size(const T& value) {
+    return Size(value, PackedSchema<T>::Fields(), Indices());
+  }
+
+  static void Write(const T& value, uint8_t** p) {
+    Write(value, p, PackedSchema<T>::Fields(), Indices());
+  }
+
+  static bool Read(PackedInput* in, T* out) {
+    return Read(in, out, PackedSchema<T>::Fields(), Indices());
+  }
+
+  // Reads an object literal, so that all objects of T share a shape.
+  static std::string Reader(PackedCodeGen* gen) {
+    std::string name;
+    if (gen->Declare<T>('r', &name)) {
+      std::string properties;
+      AddReaders(gen, &properties, PackedSchema<T>::Fields(), Indices());
+      gen->Add("function " + name + "() { return {" + properties + "}; }\n");
+    }
+    return name;
+  }
+
+  static std::string Writer(PackedCodeGen* gen) {
+    std::string name;
+    if (gen->Declare<T>('w', &name)) {
+      std::string statements;
+      AddWriters(gen, &statements, PackedSchema<T>::Fields(), Indices());
+      gen->Add("function " + name + "(x) { w_obj(x);" + statements + " }\n");
+    }
+    return name;
+  }
+
+ private:
+  template <size_t... I>
+  static size_t Size(const T& value, const Fields& fields,
+                     std::index_sequence<I...>) {
+    size_t size = 0;
+    int dummy[] = {0, (size += FieldSize(value, std::get<I>(fields)), 0)...};
+    (void)dummy;
+    return size;
+  }
+
+  template <size_t... I>
+  static void Write(const T& value, uint8_t** p, const Fields& fields,
+                    std::index_sequence<I...>) {
+    int dummy[] = {0, (WriteField(value, p, std::get<I>(fields)), 0)...};
+    (void)dummy;
+  }
+
+  template <size_t... I>
+  static bool Read(PackedInput* in, T* out, const Fields& fields,
+                   std::index_sequence<I...>) {
+    bool ok = true;
+    int dummy[] = {0, (ok = ok && ReadField(in, out, std::get<I>(fields)),
+                       0)...};
+    (void)dummy;
+    return ok;
+  }
+
+  template <size_t... I>
+  static void AddReaders(PackedCodeGen* gen, std::string* properties,
+                         const Fields& fields, std::index_sequence<I...>) {
+    int dummy[] = {0, (AddReader(gen, properties, std::get<I>(fields)), 0)...};
+    (void)dummy;
+  }
+
+  template <size_t... I>
+  static void AddWriters(PackedCodeGen* gen, std::string* statements,
+                         const Fields& fields, std::index_sequence<I...>) {
+    int dummy[] = {0, (AddWriter(gen, statements, std::get<I>(fields)), 0)...};
+    (void)dummy;
+  }
+
+  template <typename M>
+  static size_t FieldSize(const T& value, const PackedField<T, M>& field) {
+    return PackedTraits<M>::Size(value.*field.member);
+  }
+
+  template <typename M>
+  static void WriteField(const T& value, uint8_t** p,
+                         const PackedField<T, M>& field) {
+    PackedTraits<M>::Write(value.*field.member, p);
+  }
+
+  template <typename M>
+  static bool ReadField(PackedInput* in, T* out,
+                        const PackedField<T, M>& field) {
+    return PackedTraits<M>::Read(in, &(out->*field.member));
+  }
+
+  template <typename M>
+  static void AddReader(PackedCodeGen* gen, std::string* properties,
+                        const PackedField<T, M>& field) {
+    if (!properties->empty()) *properties += ", ";
+    *properties +=
+        QuoteJS(field.name) + ": " + PackedTraits<M>::Reader(gen) + "()";
+  }
+
+  template <typename M>
+  static void AddWriter(PackedCodeGen* gen, std::string* statements,
+                        const PackedField<T, M>& field) {
+    *statements += " " + PackedTraits<M>::Writer(gen) + "(x[" +
+                   QuoteJS(field.name) + "]);";
+  }
+};
+
+// The helpers of every codec. |buf| is the buffer being read or written,
+// |p| the offset in it. Writers throw |mismatch| for values of wrong types,
+// which encode() turns into undefined.
+constexpr const char kPackedPreludeSource[] =
+    "const le = new Uint8Array(new Uint16Array([1]).buffer)[0] === 1;\n"
+    "const utf8Decoder = new TextDecoder();\n"
+    "const utf8Encoder = new TextEncoder();\n"
+    "const mismatch = {};\n"
+    "let buf, u8, v, p = 0, hint = 64;\n"
+    "function fail() { throw mismatch; }\n"
+    "function num(x) { return typeof x === 'number' ? x : fail(); }\n"
+    "function reserve(n) {\n"
+    "  if (p + n <= buf.byteLength) return;\n"
+    "  let size = buf.byteLength * 2;\n"
+    "  while (size < p + n) size *= 2;\n"
+    "  const grown = new Uint8Array(size);\n"
+    "  grown.set(u8.subarray(0, p));\n"
+    "  buf = grown.buffer; u8 = grown; v = new DataView(buf);\n"
+    "}\n"
+    "function r_bool() { return u8[p++] !== 0; }\n"
+    "function w_bool(x) {\n"
+    "  if (typeof x !== 'boolean') fail();\n"
+    "  reserve(1); u8[p++] = x ? 1 : 0;\n"
+    "}\n"
+    "function r_str() {\n"
+    "  const n = r_u32(), end = p + n;\n"
+    "  if (n < 32) {\n"
+    "    let s = '', i = p;\n"
+    "    for (; i < end && u8[i] < 0x80; ++i) {\n"
+    "      s += String.fromCharCode(u8[i]);\n"
+    "    }\n"
+    "    if (i === end) { p = end; return s; }\n"
+    "  }\n"
+    "  const s = utf8Decoder.decode(u8.subarray(p, end));\n"
+    "  p = end;\n"
+    "  return s;\n"
+    "}\n"
+    "function w_str(x) {\n"
+    "  if (typeof x !== 'string') fail();\n"
+    "  reserve(4 + x.length * 3);\n"
+    "  const n = utf8Encoder.encodeInto(x, u8.subarray(p + 4)).written;\n"
+    "  v.setUint32(p, n, le); p += 4 + n;\n"
+    "}\n"
+    "function r_arr(f) {\n"
+    "  const n = r_u32(), a = new Array(n);\n"
+    "  for (let i = 0; i < n; ++i) a[i] = f();\n"
+    "  return a;\n"
+    "}\n"
+    "function w_arr(f, x) {\n"
+    "  if (!Array.isArray(x)) fail();\n"
+    "  w_u32(x.length);\n"
+    "  for (let i = 0; i < x.length; ++i) f(x[i]);\n"
+    "}\n"
+    "function w_obj(x) { if (x === null || typeof x !== 'object') fail(); }\n";
+
+struct PackedNumberType {
+  const char* name;
+  const char* view_type;
+  int size;
+};
+
+// DataView accessors of numbers. 64-bit integers are BigInts in JS if
+// NAPI_EXPERIMENTAL is on, like TypeConvertor<int64_t>.
+inline std::string PackedNumberHelpers() {
+  static const PackedNumberType kTypes[] = {
+      {"i8", "Int8", 1},         {"u8", "Uint8", 1},
+      {"i16", "Int16", 2},       {"u16", "Uint16", 2},
+      {"i32", "Int32", 4},       {"u32", "Uint32", 4},
+      {"i64", "BigInt64", 8},    {"u64", "BigUint64", 8},
+      {"f32", "Float32", 4},     {"f64", "Float64", 8},
+  };
+  std::string helpers;
+  for (const PackedNumberType& type : kTypes) {
+    std::string size = std::to_string(type.size);
+    std::string value = "v.get" + std::string(type.view_type) + "(p, le)";
+    std::string arg = "num(x)";
+    if (type.size == 8 && type.view_type[0] == 'B') {
+#ifdef NAPI_EXPERIMENTAL
+      arg = "(typeof x === 'bigint' ? x : fail())";
+#else
+      value = "Number(" + value + ")";
+      arg = "BigInt(Math.trunc(num(x)))";
+#endif
+    }
+    helpers += "function r_" + std::string(type.name) + "() { const x = " +
+               value + "; p += " + size + "; return x; }\n";
+    helpers += "function w_" + std::string(type.name) + "(x) { reserve(" +
+               size + "); v.set" + type.view_type + "(p, " + arg +
+               ", le); p += " + size + "; }\n";
+  }
+  return helpers;
+}
+
+// Returns the source of the codec of T, which evaluates to
+// {encode, decode}. decode(buffer) reads an ArrayBuffer packed by native
+// code. encode(value) packs |value| into a Uint8Array, or returns undefined
+// if it doesn't match the schema.
+template <typename T>
+std::string PackedCodecSource() {
+  PackedCodeGen gen;
+  std::string reader = PackedTraits<T>::Reader(&gen);
+  std::string writer = PackedTraits<T>::Writer(&gen);
+  return "(function() {\n" + std::string(kPackedPreludeSource) +
+         PackedNumberHelpers() + gen.functions() +
+         "function decode(buffer) {\n"
+         "  buf = buffer; u8 = new Uint8Array(buf); v = new DataView(buf);\n"
+         "  p = 0;\n"
+         "  return " + reader + "();\n"
+         "}\n"
+         "function encode(value) {\n"
+         "  const outer = [buf, u8, v, p];\n"
+         "  u8 = new Uint8Array(hint); buf = u8.buffer;\n"
+         "  v = new DataView(buf); p = 0;\n"
+         "  try {\n"
+         "    " + writer + "(value);\n"
+         "    hint = Math.max(64, p);\n"
+         "    return u8.subarray(0, p);\n"
+         "  } catch (e) {\n"
+         "    if (e !== mismatch) throw e;\n"
+         "    return undefined;\n"
+         "  } finally {\n"
+         "    [buf, u8, v, p] = outer;\n"
+         "  }\n"
+         "}\n"
+         "return {encode, decode};\n"
+         "})()";
+}
+
+template <typename T>
+Napi::Value DefinePackedCodec(Napi::Env env) {
+  return RunScript(env, PackedCodecSource<T>().c_str());
+}
+
+// It is never destroyed, since cleanup hooks of envs refer to it.
+template <typename T>
+LazyExport& PackedCodecExport() {
+  static LazyExport* codec =
+      new LazyExport("PackedCodec", &DefinePackedCodec<T>);
+  return *codec;
+}
+
+inline Napi::Value CallPackedCodec(Napi::Value codec, const char* name,
+                                   napi_value arg) {
+  Napi::Env env = codec.Env();
+  napi_value function, result;
+  if (napi_get_named_property(env, codec, name, &function) != napi_ok ||
+      napi_call_function(env, codec, function, 1, &arg, &result) != napi_ok) {
+    return Napi::Value();
+  }
+  return Napi::Value(env, result);
+}
+
+// Unpacks |value|, which is an ArrayBuffer or a Uint8Array, into |out|.
+// Returns false unless it holds exactly one T.
+template <typename T>
+bool UnpackBytes(const Napi::Value& value, T* out) {
+  napi_env env = value.Env();
+  void* data = nullptr;
+  size_t size = 0;
+  if (value.IsArrayBuffer()) {
+    napi_get_arraybuffer_info(env, value, &data, &size);
+  } else {
+    napi_typedarray_type type;
+    if (!value.IsTypedArray() ||
+        napi_get_typedarray_info(env, value, &type, &size, &data, nullptr,
+                                 nullptr) != napi_ok ||
+        type != napi_uint8_array) {
+      return false;
+    }
+  }
+  PackedInput in(static_cast<const uint8_t*>(data), size);
+  return PackedTraits<T>::Read(&in, out) && in.remaining() == 0;
+}
+
+}  // namespace internal
+
+// Returns the JS codec of Packed<T>, {encode, decode}, e.g. to decode
+// buffers packed by native code on another thread.
+template <typename T>
+Napi::Value PackedCodec(Napi::Env env) {
+  return internal::PackedCodecExport<T>().Get(env);
+}
+
+template <typename T>
+class TypeConvertor<Packed<T>> {
+ public:
+  // Takes an object matching PackedSchema<T>, or its packed bytes.
+  static bool TryToNativeValue(const Napi::Value& value, Packed<T>* out) {
+    if (value.IsArrayBuffer() || value.IsTypedArray()) {
+      return internal::UnpackBytes(value, &out->value());
+    }
+    Napi::Value codec = PackedCodec<T>(value.Env());
+    if (codec.IsEmpty()) return false;
+    Napi::Value bytes = internal::CallPackedCodec(codec, "encode", value);
+    if (bytes.IsEmpty() || bytes.IsUndefined()) return false;
+    return internal::UnpackBytes(bytes, &out->value());
+  }
+
+  static Packed<T> ToNativeValue(const Napi::Value& value) {
+    Packed<T> native;
+    TryToNativeValue(value, &native);
+    return native;
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    Packed<T> native;
+    return TryToNativeValue(value, &native);
+  }
+
+  static Napi::Value ToJSValue(Napi::Env env, const Packed<T>& value) {
+    Napi::Value codec = PackedCodec<T>(env);
+    if (codec.IsEmpty()) return Napi::Value();
+
+    size_t size = internal::PackedTraits<T>::Size(value.value());
+    void* data;
+    napi_value buffer;
+    if (napi_create_arraybuffer(env, size, &data, &buffer) != napi_ok) {
+      Napi::Error::New(env).ThrowAsJavaScriptException();
+      return Napi::Value();
+    }
+    uint8_t* p = static_cast<uint8_t*>(data);
+    internal::PackedTraits<T>::Write(value.value(), &p);
+    return internal::CallPackedCodec(codec, "decode", buffer);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Packed<T>& value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+template <typename T>
+struct JSTypeOf<Packed<T>> : JSTypes<napi_object> {};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_PACKED_H_
@@ -0,0 +1,158 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_PROFILE_H_
+#define NODE_BINDING_PROFILE_H_
+
+// Counts heap allocations and N-API handles made by bound calls, and adds
+// them to their spans in the trace. See node_binding/trace.h. It is meant for
+// a harness, see test/profile/run.sh, which
+//
+//  1. builds addons with -DNODE_BINDING_PROFILING and
+//     -include node_binding/profile.h, so that N-API calls of napi.h are
+//     counted as well, and
+//  2. preloads the counting allocator of test/profile, which keeps the
+//     counters of each thread.
+//
+// If NODE_BINDING_PROFILE is set to a directory, each addon starts tracing
+// when it is first called, and writes its trace there at exit.
+
+#if defined(NODE_BINDING_PROFILING)
+
+#if defined(_WIN32)
+#error "Profiling relies on weak symbols and LD_PRELOAD."
+#endif
+
+#include <stdint.h>
+
+#include <node_api.h>
+
+#if !defined(NODE_BINDING_TRACING)
+#define NODE_BINDING_TRACING
+#endif
+
+extern "C" {
+
+struct NodeBindingCounters {
+  uint64_t allocations;
+  uint64_t bytes;
+  uint64_t handles;
+};
+
+// Returns the counters of the calling thread. It is defined by the counting
+// allocator, and is nullptr unless it is preloaded.
+__attribute__((weak)) NodeBindingCounters* node_binding_counters();
+
+}  // extern "C"
+
+namespace node_binding {
+
+namespace internal {
+
+inline napi_status CountHandle(napi_status status) {
+  if (status == napi_ok && node_binding_counters) {
+    ++node_binding_counters()->handles;
+  }
+  return status;
+}
+
+}  // namespace internal
+
+}  // namespace node_binding
+
+// Counts N-API calls creating a napi_value. A function-like macro isn't
+// expanded again inside its own expansion, so each still calls N-API.
+#define NODE_BINDING_COUNT_HANDLE(call) \
+  ::node_binding::internal::CountHandle(call)
+
+#define napi_call_function(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_call_function(__VA_ARGS__))
+#define napi_coerce_to_bool(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_coerce_to_bool(__VA_ARGS__))
+#define napi_coerce_to_number(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_coerce_to_number(__VA_ARGS__))
+#define napi_coerce_to_object(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_coerce_to_object(__VA_ARGS__))
+#define napi_coerce_to_string(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_coerce_to_string(__VA_ARGS__))
+#define napi_create_array(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_array(__VA_ARGS__))
+#define napi_create_array_with_length(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_array_with_length(__VA_ARGS__))
+#define napi_create_arraybuffer(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_arraybuffer(__VA_ARGS__))
+#define napi_create_bigint_int64(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_bigint_int64(__VA_ARGS__))
+#define napi_create_bigint_uint64(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_bigint_uint64(__VA_ARGS__))
+#define napi_create_bigint_words(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_bigint_words(__VA_ARGS__))
+#define napi_create_buffer(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_buffer(__VA_ARGS__))
+#define napi_create_buffer_copy(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_buffer_copy(__VA_ARGS__))
+#define napi_create_dataview(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_dataview(__VA_ARGS__))
+#define napi_create_date(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_date(__VA_ARGS__))
+#define napi_create_double(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_double(__VA_ARGS__))
+#define napi_create_error(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_error(__VA_ARGS__))
+#define napi_create_external(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_external(__VA_ARGS__))
+#define napi_create_external_arraybuffer(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_external_arraybuffer(__VA_ARGS__))
+#define napi_create_external_buffer(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_external_buffer(__VA_ARGS__))
+#define napi_create_function(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_function(__VA_ARGS__))
+#define napi_create_int32(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_int32(__VA_ARGS__))
+#define napi_create_int64(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_int64(__VA_ARGS__))
+#define napi_create_object(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_object(__VA_ARGS__))
+#define napi_create_promise(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_promise(__VA_ARGS__))
+#define napi_create_range_error(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_range_error(__VA_ARGS__))
+#define napi_create_string_latin1(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_string_latin1(__VA_ARGS__))
+#define napi_create_string_utf16(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_string_utf16(__VA_ARGS__))
+#define napi_create_string_utf8(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_string_utf8(__VA_ARGS__))
+#define napi_create_symbol(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_symbol(__VA_ARGS__))
+#define napi_create_type_error(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_type_error(__VA_ARGS__))
+#define napi_create_typedarray(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_typedarray(__VA_ARGS__))
+#define napi_create_uint32(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_create_uint32(__VA_ARGS__))
+#define napi_define_class(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_define_class(__VA_ARGS__))
+#define napi_get_element(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_get_element(__VA_ARGS__))
+#define napi_get_global(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_get_global(__VA_ARGS__))
+#define napi_get_named_property(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_get_named_property(__VA_ARGS__))
+#define napi_get_property(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_get_property(__VA_ARGS__))
+#define napi_get_property_names(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_get_property_names(__VA_ARGS__))
+#define napi_get_prototype(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_get_prototype(__VA_ARGS__))
+#define napi_get_reference_value(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_get_reference_value(__VA_ARGS__))
+#define napi_new_instance(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_new_instance(__VA_ARGS__))
+#define napi_run_script(...) \
+  NODE_BINDING_COUNT_HANDLE(napi_run_script(__VA_ARGS__))
+
+#endif  // defined(NODE_BINDING_PROFILING)
+
+#endif  // NODE_BINDING_PROFILE_H_
@@ -0,0 +1,228 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_RAW_CALL_H_
+#define NODE_BINDING_RAW_CALL_H_
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "napi.h"
+#include "node_binding/arg_type_checker.h"
+#include "node_binding/macros.h"
+#include "node_binding/template_util.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+namespace internal {
+
+template <typename F>
+struct Signature;
+
+template <typename R, typename... Args>
+struct Signature<R (*)(Args...)> {
+  using ReturnType = R;
+  using ArgList = TypeList<Args...>;
+  static constexpr size_t kNumArgs = sizeof...(Args);
+  static constexpr bool kIsConst = false;
+};
+
+template <typename R, typename Class, typename... Args>
+struct Signature<R (Class::*)(Args...)> {
+  using ReturnType = R;
+  using ArgList = TypeList<Args...>;
+  static constexpr size_t kNumArgs = sizeof...(Args);
+  static constexpr bool kIsConst = false;
+};
+
+template <typename R, typename Class, typename... Args>
+struct Signature<R (Class::*)(Args...) const> {
+  using ReturnType = R;
+  using ArgList = TypeList<Args...>;
+  static constexpr size_t kNumArgs = sizeof...(Args);
+  static constexpr bool kIsConst = true;
+};
+
+template <typename R, typename Class, typename... Args>
+struct Signature<R (Class::*)(Args...) const&> {
+  using ReturnType = R;
+  using ArgList = TypeList<Args...>;
+  static constexpr size_t kNumArgs = sizeof...(Args);
+  static constexpr bool kIsConst = true;
+};
+
+template <typename List>
+struct RawArgTypeChecker;
+
+template <typename... Args>
+struct RawArgTypeChecker<TypeList<Args...>> : ArgTypeChecker<Args...> {
+  using Slots = ArgSlots<Args...>;
+};
+
+// Fetches exactly |n| arguments into |args|, which is stack storage of the
+// caller. Returns false if it throws.
+inline bool FetchArgs(napi_env env, napi_callback_info cbinfo, size_t n,
+                      napi_value* args, napi_value* this_arg) {
+  size_t argc = n;
+  napi_status status =
+      napi_get_cb_info(env, cbinfo, &argc, args, this_arg, nullptr);
+  if (status != napi_ok) {
+    Napi::Error::New(env).ThrowAsJavaScriptException();
+    return false;
+  }
+  if (argc != n) {
+    THROW_JS_WRONG_NUMBER_OF_ARGUMENTS(Napi::Env(env));
+    return false;
+  }
+  return true;
+}
+
+template <size_t Idx, typename ArgList, typename Slots>
+decltype(auto) RawArg(napi_env env, const napi_value* args, Slots* slots) {
+  NODE_BINDING_TRACE_ARG();
+  return TakeArg<PickTypeListItem<Idx, ArgList>>(Napi::Value(env, args[Idx]),
+                                                  &std::get<Idx>(*slots));
+}
+
+template <typename F, typename ArgList, typename Slots, size_t... Indices>
+decltype(auto) RawInvoke(napi_env env, const napi_value* args, Slots* slots,
+                         F f, ArgList, std::index_sequence<Indices...>) {
+  (void)env;
+  (void)args;
+  (void)slots;
+  return f(RawArg<Indices, ArgList>(env, args, slots)...);
+}
+
+template <typename F, typename Class, typename ArgList, typename Slots,
+          size_t... Indices>
+decltype(auto) RawInvoke(napi_env env, const napi_value* args, Slots* slots,
+                         F f, Class* c, ArgList,
+                         std::index_sequence<Indices...>) {
+  (void)env;
+  (void)args;
+  (void)slots;
+  return (c->*f)(RawArg<Indices, ArgList>(env, args, slots)...);
+}
+
+// Prefers TypeConvertor<T>::ToJSValue(Napi::Env, ...). Otherwise falls back
+// to TypeConvertor<T>::ToJSValue(const Napi::CallbackInfo&, ...), which
+// costs constructing Napi::CallbackInfo.
+template <typename T>
+auto RawResult(napi_env env, napi_callback_info cbinfo, T&& value, int)
+    -> decltype(TypeConvertor<std::decay_t<T>>::ToJSValue(
+                    Napi::Env(env), std::forward<T>(value)),
+                napi_value()) {
+  return TypeConvertor<std::decay_t<T>>::ToJSValue(Napi::Env(env),
+                                                   std::forward<T>(value));
+}
+
+template <typename T>
+napi_value RawResult(napi_env env, napi_callback_info cbinfo, T&& value,
+                     long) {
+  Napi::CallbackInfo info(env, cbinfo);
+  return TypeConvertor<std::decay_t<T>>::ToJSValue(info,
+                                                   std::forward<T>(value));
+}
+
+// Converts the result of RawCall(), which is traced apart from the call.
+template <typename T>
+napi_value RawCallResult(napi_env env, napi_callback_info cbinfo, T&& value) {
+  NODE_BINDING_TRACE_RESULT();
+  return RawResult(env, cbinfo, std::forward<T>(value), 0);
+}
+
+template <typename Callback>
+auto RawReturn(napi_env env, napi_callback_info cbinfo, Callback&& callback)
+    -> std::enable_if_t<std::is_void<decltype(callback())>::value,
+                        napi_value> {
+  callback();
+  return nullptr;
+}
+
+template <typename Callback>
+auto RawReturn(napi_env env, napi_callback_info cbinfo, Callback&& callback)
+    -> std::enable_if_t<!std::is_void<decltype(callback())>::value,
+                        napi_value> {
+  return RawCallResult(env, cbinfo, callback());
+}
+
+}  // namespace internal
+
+// A napi_callback calling |f| without Napi::CallbackInfo. It fetches exactly
+// as many arguments as |f| takes into stack storage and converts them
+// directly from napi_value. Default arguments are not supported, use
+// TypedCall() for them.
+//
+//   napi_property_descriptor desc = {
+//       "add", nullptr, &RawCall<decltype(&CAdd), &CAdd>, ...};
+template <typename F, F f>
+napi_value RawCall(napi_env env, napi_callback_info cbinfo) {
+  NODE_BINDING_TRACE_CALL("RawCall");
+  using Signature = internal::Signature<F>;
+  constexpr size_t num_args = Signature::kNumArgs;
+  napi_value args[num_args > 0 ? num_args : 1];
+  if (!internal::FetchArgs(env, cbinfo, num_args, args, nullptr))
+    return nullptr;
+  using Checker = internal::RawArgTypeChecker<typename Signature::ArgList>;
+  typename Checker::Slots arg_slots;
+  if (!Checker::Check(env, args, 0, num_args, &arg_slots)) return nullptr;
+  NODE_BINDING_TRACE_ARGS_CHECKED();
+
+  return internal::RawReturn(
+      env, cbinfo, [env, &args, &arg_slots]() -> decltype(auto) {
+        return internal::RawInvoke(env, args, &arg_slots, f,
+                                   typename Signature::ArgList(),
+                                   std::make_index_sequence<num_args>());
+      });
+}
+
+// Same as above, but calls a member function |f| on |c|, which is obtained
+// from the JS receiver by |unwrap|. |unwrap| returns nullptr after throwing
+// if the receiver is invalid.
+template <typename F, F f, typename Class>
+napi_value RawCall(napi_env env, napi_callback_info cbinfo,
+                   Class* (*unwrap)(napi_env env, napi_value this_arg)) {
+  NODE_BINDING_TRACE_CALL("RawCall");
+  using Signature = internal::Signature<F>;
+  constexpr size_t num_args = Signature::kNumArgs;
+  napi_value args[num_args > 0 ? num_args : 1];
+  napi_value this_arg;
+  if (!internal::FetchArgs(env, cbinfo, num_args, args, &this_arg))
+    return nullptr;
+  Class* c = unwrap(env, this_arg);
+  if (c == nullptr) return nullptr;
+  using Checker = internal::RawArgTypeChecker<typename Signature::ArgList>;
+  typename Checker::Slots arg_slots;
+  if (!Checker::Check(env, args, 0, num_args, &arg_slots)) return nullptr;
+  NODE_BINDING_TRACE_ARGS_CHECKED();
+
+  return internal::RawReturn(
+      env, cbinfo, [env, &args, &arg_slots, c]() -> decltype(auto) {
+        return internal::RawInvoke(env, args, &arg_slots, f, c,
+                                   typename Signature::ArgList(),
+                                   std::make_index_sequence<num_args>());
+      });
+}
+
+// Creates a JS function calling |f| through RawCall().
+//
+//   exports.Set("add", NewRawFunction(env, "add", NODE_BINDING_MEMBER(&CAdd)));
+template <typename F, F f>
+Napi::Function NewRawFunction(Napi::Env env, const char* name,
+                              std::integral_constant<F, f>) {
+  napi_value func;
+  napi_status status = napi_create_function(env, name, NAPI_AUTO_LENGTH,
+                                            &RawCall<F, f>, nullptr, &func);
+  if (status != napi_ok) {
+    Napi::Error::New(env).ThrowAsJavaScriptException();
+    return Napi::Function();
+  }
+  return Napi::Function(env, func);
+}
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_RAW_CALL_H_
@@ -0,0 +1,184 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_RECLAIMER_H_
+#define NODE_BINDING_RECLAIMER_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "node_binding/object_pool.h"
+#include "node_binding/trace.h"
+
+namespace node_binding {
+
+// Where a wrapped native object is destroyed when its JS object is collected.
+enum class Destruction {
+  // In the finalizer on the JS thread. Objects holding JS handles or
+  // anything else bound to the JS thread need it.
+  kOnJSThread,
+  // On the reclaimer thread, so that freeing a large object doesn't pause
+  // the event loop.
+  kDeferred,
+};
+
+// Specialize it to destroy a class bound by Class<T> on the reclaimer thread.
+//
+//   template <>
+//   struct DestructionPolicy<Tree> {
+//     static constexpr Destruction value = Destruction::kDeferred;
+//   };
+template <typename T, typename SFINAE = void>
+struct DestructionPolicy {
+  static constexpr Destruction value = Destruction::kOnJSThread;
+};
+
+// A background thread destroying native objects handed over by finalizers.
+// The queue is bounded. When it is full, the object is destroyed on the
+// calling thread instead of blocking it.
+class Reclaimer {
+ public:
+  struct Stats {
+    // Number of objects waiting for or under destruction.
+    size_t pending;
+    // Maximum of |pending| so far.
+    size_t max_pending;
+    uint64_t enqueued;
+    uint64_t reclaimed;
+    // Number of objects destroyed on the calling thread, since the queue
+    // was full.
+    uint64_t overflowed;
+  };
+
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  static Reclaimer& GetInstance() {
+    static Reclaimer reclaimer;
+    return reclaimer;
+  }
+
+  Reclaimer(const Reclaimer& other) = delete;
+  Reclaimer& operator=(const Reclaimer& other) = delete;
+
+  ~Reclaimer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    queued_.notify_one();
+    if (thread_.joinable()) thread_.join();
+  }
+
+  // Destroys |object|, created by new or Constructor<T>::CallNew, on the
+  // reclaimer thread.
+  template <typename T>
+  void Delete(T* object) {
+    if (object == nullptr) return;
+    if (!Enqueue({object, &DeleteObject<T>})) internal::DeleteNative(object);
+  }
+
+  void set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+  }
+
+  Stats stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  // Blocks until every queued object is destroyed.
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this]() { return stats_.pending == 0; });
+  }
+
+ private:
+  struct Item {
+    void* object;
+    void (*destroy)(void* object);
+  };
+
+  Reclaimer() = default;
+
+  template <typename T>
+  static void DeleteObject(void* object) {
+    internal::DeleteNative(static_cast<T*>(object));
+  }
+
+  bool Enqueue(Item item) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_ || stats_.pending >= capacity_) {
+        ++stats_.overflowed;
+        return false;
+      }
+      if (!thread_.joinable()) thread_ = std::thread(&Reclaimer::Run, this);
+      queue_.push_back(item);
+      ++stats_.pending;
+      ++stats_.enqueued;
+      stats_.max_pending = std::max(stats_.max_pending, stats_.pending);
+    }
+    queued_.notify_one();
+    return true;
+  }
+
+  void Run() {
+    std::deque<Item> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      queued_.wait(lock, [this]() { return stopped_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+
+      // Destroys a whole batch without the lock, so that finalizers don't
+      // wait for destructors.
+      batch.swap(queue_);
+      lock.unlock();
+      {
+        NODE_BINDING_TRACE_SCOPE("Reclaim");
+        for (const Item& item : batch) item.destroy(item.object);
+      }
+      size_t reclaimed = batch.size();
+      batch.clear();
+      lock.lock();
+
+      stats_.pending -= reclaimed;
+      stats_.reclaimed += reclaimed;
+      if (stats_.pending == 0) drained_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable queued_;
+  std::condition_variable drained_;
+  std::deque<Item> queue_;
+  size_t capacity_ = kDefaultCapacity;
+  bool stopped_ = false;
+  Stats stats_ = {};
+  std::thread thread_;
+};
+
+// A deleter of std::unique_ptr destroying on the reclaimer thread, for a
+// hand-written ObjectWrap owning a large native object.
+//
+//   class TreeJs : public Napi::ObjectWrap<TreeJs> {
+//    private:
+//     std::unique_ptr<Tree, DeferredDeleter<Tree>> tree_;
+//   };
+template <typename T>
+struct DeferredDeleter {
+  void operator()(T* object) const {
+    Reclaimer::GetInstance().Delete(object);
+  }
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_RECLAIMER_H_
@@ -0,0 +1,280 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_SHARED_MEMORY_H_
+#define NODE_BINDING_SHARED_MEMORY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+#include "napi.h"
+#include "node_binding/span.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+// Containers in this file live in a SharedArrayBuffer, which can be posted
+// to workers, and are accessed from any thread without locks. Their memory
+// is kept while a JS handle to it is alive in any env. A native thread using
+// them must make sure of it, e.g. by keeping a reference until it finishes.
+
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t) &&
+                  ATOMIC_INT_LOCK_FREE == 2,
+              "Atomics of JS and C++ must be compatible.");
+
+namespace internal {
+
+// Creates a TypedArray of |class_name| over a new zeroed SharedArrayBuffer.
+inline Napi::Value NewSharedTypedArray(Napi::Env env, const char* class_name,
+                                       size_t byte_length) {
+  Napi::Object global = env.Global();
+  Napi::Value buffer = global.Get("SharedArrayBuffer")
+                           .As<Napi::Function>()
+                           .New({Napi::Number::New(env, byte_length)});
+  if (env.IsExceptionPending()) return Napi::Value();
+  return global.Get(class_name).As<Napi::Function>().New({buffer});
+}
+
+}  // namespace internal
+
+// A table of int32 counters in an Int32Array, which JS updates with
+// Atomics and native code through this view.
+//
+//   const counters = newCounters(2);  // Int32Array
+//   Atomics.add(counters, 0, 1);
+//
+//   void Count(SharedCounters counters) { counters.Add(1, 1); }
+class SharedCounters {
+ public:
+  SharedCounters(std::atomic<int32_t>* counters, size_t size)
+      : counters_(counters), size_(size) {}
+
+  // Returns an Int32Array over a new SharedArrayBuffer.
+  static Napi::Value New(Napi::Env env, size_t size) {
+    return internal::NewSharedTypedArray(env, "Int32Array",
+                                         size * sizeof(int32_t));
+  }
+
+  size_t size() const { return size_; }
+
+  int32_t Load(size_t i) const { return counters_[i].load(); }
+
+  void Store(size_t i, int32_t value) { counters_[i].store(value); }
+
+  // Returns the previous value, as Atomics.add() does.
+  int32_t Add(size_t i, int32_t delta) {
+    return counters_[i].fetch_add(delta);
+  }
+
+  bool CompareExchange(size_t i, int32_t* expected, int32_t desired) {
+    return counters_[i].compare_exchange_strong(*expected, desired);
+  }
+
+ private:
+  std::atomic<int32_t>* counters_;
+  size_t size_;
+};
+
+template <>
+class TypeConvertor<SharedCounters> {
+ public:
+  static SharedCounters ToNativeValue(const Napi::Value& value) {
+    Span<int32_t> span = TypeConvertor<Span<int32_t>>::ToNativeValue(value);
+    return SharedCounters(
+        reinterpret_cast<std::atomic<int32_t>*>(span.data()), span.size());
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return TypeConvertor<Span<int32_t>>::IsConvertible(value);
+  }
+};
+
+// A bounded queue of T, which any number of threads push to and pop from
+// concurrently. It is held by a Uint8Array over a SharedArrayBuffer.
+// Positions are claimed by compare-and-swap, and each slot has a sequence
+// number telling whether it is ready to be written or read, so neither side
+// waits for a lock.
+//
+//   const queue = newQueue(1024);  // Uint8Array
+//   worker.postMessage(queue);
+//
+//   bool Push(SharedRingBuffer<int32_t> queue, int32_t value) {
+//     return queue.TryPush(value);
+//   }
+template <typename T>
+class SharedRingBuffer {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Elements are copied between threads as bytes.");
+  static_assert(alignof(T) <= 8,
+                "SharedArrayBuffer only guarantees 8 bytes alignment.");
+
+  // Returns a Uint8Array over a new SharedArrayBuffer holding a queue of at
+  // least |capacity| elements, which is rounded up to a power of two.
+  static Napi::Value New(Napi::Env env, uint32_t capacity) {
+    uint32_t rounded = 1;
+    while (rounded < capacity && rounded < (1u << 30)) rounded <<= 1;
+
+    Napi::Value value = internal::NewSharedTypedArray(
+        env, "Uint8Array", sizeof(Header) + rounded * sizeof(Slot));
+    if (value.IsEmpty()) return value;
+
+    Span<uint8_t> bytes = TypeConvertor<Span<uint8_t>>::ToNativeValue(value);
+    Header* header = new (bytes.data()) Header();
+    header->magic = kMagic;
+    header->element_size = sizeof(T);
+    header->capacity = rounded;
+    Slot* slots = reinterpret_cast<Slot*>(header + 1);
+    for (uint32_t i = 0; i < rounded; ++i) {
+      new (&slots[i].sequence) std::atomic<uint32_t>(i);
+    }
+    return value;
+  }
+
+  // Returns whether |bytes| holds a queue of T.
+  static bool IsValid(Span<uint8_t> bytes) {
+    if (bytes.size() < sizeof(Header) ||
+        reinterpret_cast<uintptr_t>(bytes.data()) % alignof(Header) != 0) {
+      return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(bytes.data());
+    return header->magic == kMagic && header->element_size == sizeof(T) &&
+           header->capacity > 0 &&
+           (header->capacity & (header->capacity - 1)) == 0 &&
+           bytes.size() >= sizeof(Header) + header->capacity * sizeof(Slot);
+  }
+
+  // JS can write the header at any time, e.g. after IsValid(), so its
+  // capacity is taken once here, and clamped to the slots in |bytes|.
+  explicit SharedRingBuffer(Span<uint8_t> bytes)
+      : header_(reinterpret_cast<Header*>(bytes.data())),
+        slots_(reinterpret_cast<Slot*>(header_ + 1)),
+        capacity_(CapacityOf(bytes)),
+        mask_(capacity_ - 1) {}
+
+  // Returns 0 if |bytes| doesn't hold a queue, which is then always full and
+  // empty.
+  uint32_t capacity() const { return capacity_; }
+
+  // Returns false if it is full.
+  bool TryPush(const T& value) {
+    if (capacity_ == 0) return false;
+    const uint32_t mask = mask_;
+    uint32_t pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[pos & mask];
+      uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+      int32_t diff = static_cast<int32_t>(sequence - pos);
+      if (diff == 0) {
+        if (header_->enqueue_pos.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    memcpy(&slot->value, &value, sizeof(T));
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Returns false if it is empty.
+  bool TryPop(T* value) {
+    if (capacity_ == 0) return false;
+    const uint32_t mask = mask_;
+    uint32_t pos = header_->dequeue_pos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[pos & mask];
+      uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+      int32_t diff = static_cast<int32_t>(sequence - (pos + 1));
+      if (diff == 0) {
+        if (header_->dequeue_pos.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = header_->dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    memcpy(value, &slot->value, sizeof(T));
+    slot->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  static constexpr uint32_t kMagic = 0x4e425242;  // "NBRB"
+  static constexpr size_t kCacheLineSize = 64;
+
+  // Positions are on their own cache lines, so that producers and consumers
+  // don't invalidate each other's.
+  struct Header {
+    uint32_t magic;
+    uint32_t element_size;
+    uint32_t capacity;
+    char padding0[kCacheLineSize - 3 * sizeof(uint32_t)];
+    std::atomic<uint32_t> enqueue_pos{0};
+    char padding1[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint32_t> dequeue_pos{0};
+    char padding2[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+  };
+
+  struct Slot {
+    std::atomic<uint32_t> sequence;
+    T value;
+  };
+
+  // Returns the capacity in the header of |bytes|, rounded down to a power of
+  // two which fits in |bytes|, or 0 if not even a slot does.
+  static uint32_t CapacityOf(Span<uint8_t> bytes) {
+    if (bytes.size() < sizeof(Header) + sizeof(Slot) ||
+        reinterpret_cast<uintptr_t>(bytes.data()) % alignof(Header) != 0) {
+      return 0;
+    }
+    const size_t fit = (bytes.size() - sizeof(Header)) / sizeof(Slot);
+    const uint32_t capacity =
+        reinterpret_cast<const Header*>(bytes.data())->capacity;
+    const size_t limit = std::min<size_t>(capacity, fit);
+    if (limit == 0) return 0;
+    uint32_t rounded = 1;
+    while (rounded <= limit / 2 && rounded < (1u << 30)) rounded <<= 1;
+    return rounded;
+  }
+
+  Header* header_;
+  Slot* slots_;
+  uint32_t capacity_;
+  uint32_t mask_;
+};
+
+template <typename T>
+class TypeConvertor<SharedRingBuffer<T>> {
+ public:
+  static SharedRingBuffer<T> ToNativeValue(const Napi::Value& value) {
+    return SharedRingBuffer<T>(
+        TypeConvertor<Span<uint8_t>>::ToNativeValue(value));
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return TypeConvertor<Span<uint8_t>>::IsConvertible(value) &&
+           SharedRingBuffer<T>::IsValid(
+               TypeConvertor<Span<uint8_t>>::ToNativeValue(value));
+  }
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_SHARED_MEMORY_H_
@@ -0,0 +1,166 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_SPAN_H_
+#define NODE_BINDING_SPAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "napi.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+// Maps an element type to the type of TypedArray holding it.
+template <typename T>
+struct TypedArrayTypeOf {};
+
+#define DEFINE_TYPED_ARRAY_TYPE_OF(Type, TypedArrayType) \
+  template <>                                            \
+  struct TypedArrayTypeOf<Type>                          \
+      : std::integral_constant<napi_typedarray_type, TypedArrayType> {}
+
+DEFINE_TYPED_ARRAY_TYPE_OF(int8_t, napi_int8_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(uint8_t, napi_uint8_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(int16_t, napi_int16_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(uint16_t, napi_uint16_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(int32_t, napi_int32_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(uint32_t, napi_uint32_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(float, napi_float32_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(double, napi_float64_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(int64_t, napi_bigint64_array);
+DEFINE_TYPED_ARRAY_TYPE_OF(uint64_t, napi_biguint64_array);
+
+#undef DEFINE_TYPED_ARRAY_TYPE_OF
+
+namespace internal {
+
+// Gets the contents of a SharedArrayBuffer. N-API can't inspect it, so it
+// is read through a Uint8Array over it. Returns false if |value| isn't a
+// SharedArrayBuffer.
+inline bool GetSharedArrayBufferInfo(napi_env env, napi_value value,
+                                     void** data, size_t* length) {
+  napi_valuetype type;
+  napi_typeof(env, value, &type);
+  if (type != napi_object) return false;
+
+  napi_value global;
+  napi_value shared_array_buffer_class;
+  napi_get_global(env, &global);
+  if (napi_get_named_property(env, global, "SharedArrayBuffer",
+                              &shared_array_buffer_class) != napi_ok) {
+    return false;
+  }
+  bool is_shared = false;
+  napi_instanceof(env, value, shared_array_buffer_class, &is_shared);
+  if (!is_shared) return false;
+
+  napi_value uint8_array_class;
+  napi_value view;
+  napi_get_named_property(env, global, "Uint8Array", &uint8_array_class);
+  if (napi_new_instance(env, uint8_array_class, 1, &value, &view) != napi_ok) {
+    return false;
+  }
+  return napi_get_typedarray_info(env, view, nullptr, length, data, nullptr,
+                                  nullptr) == napi_ok;
+}
+
+}  // namespace internal
+
+// A view of contiguous elements owned by someone else.
+//
+// As an argument, it refers to the contents of a TypedArray of T, or of an
+// ArrayBuffer, a SharedArrayBuffer or a Uint8Array if T is uint8_t, without
+// copying. It is valid only during the bound call, since the buffer may be
+// collected afterwards. A TypedArray over a SharedArrayBuffer is viewed the
+// same way, so its contents may be changed by other threads meanwhile.
+//
+//   float Sum(Span<const float> values) {
+//     return std::accumulate(values.begin(), values.end(), 0.0f);
+//   }
+template <typename T>
+class Span {
+ public:
+  Span() = default;
+  Span(T* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename U, typename = std::enable_if_t<
+                            std::is_convertible<U (*)[], T (*)[]>::value>>
+  Span(const Span<U>& other) : data_(other.data()), size_(other.size()) {}
+
+  T* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  T* begin() const { return data_; }
+  T* end() const { return data_ + size_; }
+
+  T& operator[](size_t i) const { return data_[i]; }
+
+  Span subspan(size_t offset, size_t count) const {
+    return Span(data_ + offset, count);
+  }
+
+ private:
+  T* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+template <typename T>
+class TypeConvertor<Span<T>> {
+ public:
+  using Element = std::remove_const_t<T>;
+
+  static Span<T> ToNativeValue(const Napi::Value& value) {
+    void* data = nullptr;
+    size_t length = 0;
+    if (value.IsTypedArray()) {
+      napi_typedarray_type type;
+      napi_get_typedarray_info(value.Env(), value, &type, &length, &data,
+                               nullptr, nullptr);
+      if (type == TypedArrayTypeOf<Element>::value) {
+        return Span<T>(static_cast<T*>(data), length);
+      }
+    } else if (std::is_same<Element, uint8_t>::value) {
+      if (value.IsArrayBuffer()) {
+        napi_get_arraybuffer_info(value.Env(), value, &data, &length);
+        return Span<T>(static_cast<T*>(data), length);
+      }
+      if (internal::GetSharedArrayBufferInfo(value.Env(), value, &data,
+                                             &length)) {
+        return Span<T>(static_cast<T*>(data), length);
+      }
+    }
+    // TrustedArgs converts any object without IsConvertible(), so elements
+    // of another type are never viewed as |T|.
+    Napi::TypeError::New(value.Env(), "Type of value is mismatched")
+        .ThrowAsJavaScriptException();
+    return Span<T>();
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    if (!value.IsTypedArray()) {
+      if (!std::is_same<Element, uint8_t>::value) return false;
+      if (value.IsArrayBuffer()) return true;
+      void* data;
+      size_t length;
+      return internal::GetSharedArrayBufferInfo(value.Env(), value, &data,
+                                                &length);
+    }
+    napi_typedarray_type type;
+    napi_get_typedarray_info(value.Env(), value, &type, nullptr, nullptr,
+                             nullptr, nullptr);
+    return type == TypedArrayTypeOf<Element>::value;
+  }
+};
+
+template <typename T>
+struct JSTypeOf<Span<T>> : JSTypes<napi_object> {};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_SPAN_H_
@@ -5,8 +5,18 @@
 #ifndef NODE_BINDING_STL_H_
 #define NODE_BINDING_STL_H_
 
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "node_binding/lazy_export.h"
 #include "node_binding/type_convertor.h"
 
 namespace node_binding {
@@ -33,6 +43,40 @@ class TypeConvertor<std::vector<T>> {
     return true;
   }
 
+  static bool TryToNativeValue(const Napi::Value& value, std::vector<T>* out) {
+    if (!value.IsArray()) return false;
+    napi_env env = value.Env();
+    uint32_t length;
+    napi_get_array_length(env, value, &length);
+    out->clear();
+    out->reserve(length);
+    for (uint32_t i = 0; i < length; ++i) {
+      napi_value element;
+      napi_get_element(env, value, i, &element);
+      if (!internal::TryConvert<T>(Napi::Value(env, element),
+                                   [out](auto&& native) {
+                                     out->push_back(
+                                         std::forward<decltype(native)>(
+                                             native));
+                                   })) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Only available if TypeConvertor<T> can convert without
+  // Napi::CallbackInfo.
+  template <typename U = T>
+  static auto ToJSValue(Napi::Env env, const std::vector<U>& value)
+      -> decltype(TypeConvertor<U>::ToJSValue(env, value[0])) {
+    Napi::Array ret = Napi::Array::New(env, value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+      ret[i] = TypeConvertor<U>::ToJSValue(env, value[i]);
+    }
+    return ret;
+  }
+
   static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
                                const std::vector<T>& value) {
     Napi::Array ret = Napi::Array::New(info.Env(), value.size());
@@ -43,6 +87,315 @@ class TypeConvertor<std::vector<T>> {
   }
 };
 
+namespace internal {
+
+// Enumerates and builds Maps and Sets, which N-API can't, in one call each.
+constexpr const char kCollectionHelpersSource[] =
+    "({\n"
+    "  entries(value) {\n"
+    "    if (value instanceof Map) {\n"
+    "      const flat = new Array(value.size * 2);\n"
+    "      let i = 0;\n"
+    "      for (const [key, mapped] of value) {\n"
+    "        flat[i++] = key;\n"
+    "        flat[i++] = mapped;\n"
+    "      }\n"
+    "      return flat;\n"
+    "    }\n"
+    "    if (value instanceof Set) return null;\n"
+    "    const keys = Object.keys(value);\n"
+    "    const flat = new Array(keys.length * 2);\n"
+    "    for (let i = 0; i < keys.length; ++i) {\n"
+    "      flat[2 * i] = keys[i];\n"
+    "      flat[2 * i + 1] = value[keys[i]];\n"
+    "    }\n"
+    "    return flat;\n"
+    "  },\n"
+    "  values(value) {\n"
+    "    return value instanceof Set ? Array.from(value) : null;\n"
+    "  },\n"
+    "  newMap(flat) {\n"
+    "    const map = new Map();\n"
+    "    for (let i = 0; i < flat.length; i += 2) {\n"
+    "      map.set(flat[i], flat[i + 1]);\n"
+    "    }\n"
+    "    return map;\n"
+    "  },\n"
+    "  newSet(values) {\n"
+    "    return new Set(values);\n"
+    "  },\n"
+    "})";
+
+inline Napi::Value DefineCollectionHelpers(Napi::Env env) {
+  return RunScript(env, kCollectionHelpersSource);
+}
+
+// It is never destroyed, since cleanup hooks of envs refer to it.
+inline LazyExport& CollectionHelpers() {
+  static LazyExport* helpers =
+      new LazyExport("CollectionHelpers", &DefineCollectionHelpers);
+  return *helpers;
+}
+
+// Calls the helper |name| with |arg|. Returns nullptr if it throws.
+inline napi_value CallCollectionHelper(napi_env env, const char* name,
+                                       napi_value arg) {
+  Napi::Value helpers = CollectionHelpers().Get(env);
+  if (helpers.IsEmpty()) return nullptr;
+  napi_value function;
+  napi_value result;
+  if (napi_get_named_property(env, helpers, name, &function) != napi_ok ||
+      napi_call_function(env, helpers, function, 1, &arg, &result) !=
+          napi_ok) {
+    return nullptr;
+  }
+  return result;
+}
+
+template <typename Container>
+auto Reserve(Container* container, size_t size, int)
+    -> decltype(container->reserve(size)) {
+  container->reserve(size);
+}
+
+template <typename Container>
+void Reserve(Container* container, size_t size, long) {}
+
+// Converts std::map and std::unordered_map. A JS Map is taken with any keys,
+// and an object with keys convertible from its property names. A map is
+// returned as an object if its keys are strings, otherwise as a Map.
+template <typename Map>
+class MapConvertor {
+ public:
+  using Key = typename Map::key_type;
+  using Mapped = typename Map::mapped_type;
+
+  static Map ToNativeValue(const Napi::Value& value) {
+    Map ret;
+    TryToNativeValue(value, &ret);
+    return ret;
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    Map map;
+    return TryToNativeValue(value, &map);
+  }
+
+  // Enumerates |value| into [key0, value0, key1, value1, ...] by a single
+  // call, and fetches each of them once.
+  static bool TryToNativeValue(const Napi::Value& value, Map* out) {
+    if (!value.IsObject() || value.IsArray()) return false;
+    napi_env env = value.Env();
+    napi_value flat = CallCollectionHelper(env, "entries", value);
+    if (flat == nullptr || Napi::Value(env, flat).IsNull()) return false;
+
+    uint32_t length;
+    napi_get_array_length(env, flat, &length);
+    out->clear();
+    Reserve(out, length / 2, 0);
+    for (uint32_t i = 0; i + 1 < length; i += 2) {
+      napi_value key;
+      napi_value mapped;
+      napi_get_element(env, flat, i, &key);
+      napi_get_element(env, flat, i + 1, &mapped);
+      bool converted = false;
+      TryConvert<Key>(Napi::Value(env, key), [&](auto&& native_key) {
+        converted = TryConvert<Mapped>(
+            Napi::Value(env, mapped), [&](auto&& native_mapped) {
+              out->emplace(
+                  std::forward<decltype(native_key)>(native_key),
+                  std::forward<decltype(native_mapped)>(native_mapped));
+            });
+      });
+      if (!converted) return false;
+    }
+    return true;
+  }
+
+  // Only available if TypeConvertor<Key> and TypeConvertor<Mapped> can
+  // convert without Napi::CallbackInfo.
+  template <typename M = Map>
+  static auto ToJSValue(Napi::Env env, const M& value)
+      -> decltype(TypeConvertor<Key>::ToJSValue(env, std::declval<Key>()),
+                  TypeConvertor<Mapped>::ToJSValue(env,
+                                                   std::declval<Mapped>())) {
+    return New(env, value, [env](const auto& native) {
+      return TypeConvertor<std::decay_t<decltype(native)>>::ToJSValue(env,
+                                                                      native);
+    });
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Map& value) {
+    return New(info.Env(), value, [&info](const auto& native) {
+      return TypeConvertor<std::decay_t<decltype(native)>>::ToJSValue(info,
+                                                                      native);
+    });
+  }
+
+ private:
+  template <typename Convert>
+  static Napi::Value New(Napi::Env env, const Map& value, Convert&& convert) {
+    return New(env, value, std::forward<Convert>(convert),
+               std::is_same<Key, std::string>());
+  }
+
+  // Defines all properties by a single call.
+  template <typename Convert>
+  static Napi::Value New(Napi::Env env, const Map& value, Convert&& convert,
+                         std::true_type) {
+    std::vector<napi_property_descriptor> properties;
+    properties.reserve(value.size());
+    for (const auto& entry : value) {
+      napi_value mapped = convert(entry.second);
+      if (mapped == nullptr) return Napi::Value();
+      properties.push_back({entry.first.c_str(), nullptr, nullptr, nullptr,
+                            nullptr, mapped,
+                            static_cast<napi_property_attributes>(
+                                napi_writable | napi_enumerable |
+                                napi_configurable),
+                            nullptr});
+    }
+    Napi::Object object = Napi::Object::New(env);
+    if (napi_define_properties(env, object, properties.size(),
+                               properties.data()) != napi_ok) {
+      return Napi::Value();
+    }
+    return object;
+  }
+
+  template <typename Convert>
+  static Napi::Value New(Napi::Env env, const Map& value, Convert&& convert,
+                         std::false_type) {
+    Napi::Array flat = Napi::Array::New(env, value.size() * 2);
+    uint32_t i = 0;
+    for (const auto& entry : value) {
+      napi_value key = convert(entry.first);
+      napi_value mapped = convert(entry.second);
+      if (key == nullptr || mapped == nullptr) return Napi::Value();
+      napi_set_element(env, flat, i++, key);
+      napi_set_element(env, flat, i++, mapped);
+    }
+    return Napi::Value(env, CallCollectionHelper(env, "newMap", flat));
+  }
+};
+
+// Converts std::set and std::unordered_set, which are taken from a Set or an
+// Array, and returned as a Set.
+template <typename Set>
+class SetConvertor {
+ public:
+  using Key = typename Set::key_type;
+
+  static Set ToNativeValue(const Napi::Value& value) {
+    Set ret;
+    TryToNativeValue(value, &ret);
+    return ret;
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    Set set;
+    return TryToNativeValue(value, &set);
+  }
+
+  static bool TryToNativeValue(const Napi::Value& value, Set* out) {
+    if (!value.IsObject()) return false;
+    napi_env env = value.Env();
+    napi_value values = value;
+    if (!value.IsArray()) {
+      values = CallCollectionHelper(env, "values", value);
+      if (values == nullptr || Napi::Value(env, values).IsNull()) {
+        return false;
+      }
+    }
+
+    uint32_t length;
+    napi_get_array_length(env, values, &length);
+    out->clear();
+    Reserve(out, length, 0);
+    for (uint32_t i = 0; i < length; ++i) {
+      napi_value element;
+      napi_get_element(env, values, i, &element);
+      if (!TryConvert<Key>(Napi::Value(env, element), [out](auto&& native) {
+            out->emplace(std::forward<decltype(native)>(native));
+          })) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Only available if TypeConvertor<Key> can convert without
+  // Napi::CallbackInfo.
+  template <typename S = Set>
+  static auto ToJSValue(Napi::Env env, const S& value)
+      -> decltype(TypeConvertor<Key>::ToJSValue(env, std::declval<Key>())) {
+    return New(env, value, [env](const Key& native) {
+      return TypeConvertor<Key>::ToJSValue(env, native);
+    });
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Set& value) {
+    return New(info.Env(), value, [&info](const Key& native) {
+      return TypeConvertor<Key>::ToJSValue(info, native);
+    });
+  }
+
+ private:
+  template <typename Convert>
+  static Napi::Value New(Napi::Env env, const Set& value, Convert&& convert) {
+    Napi::Array values = Napi::Array::New(env, value.size());
+    uint32_t i = 0;
+    for (const Key& key : value) {
+      napi_value element = convert(key);
+      if (element == nullptr) return Napi::Value();
+      napi_set_element(env, values, i++, element);
+    }
+    return Napi::Value(env, CallCollectionHelper(env, "newSet", values));
+  }
+};
+
+}  // namespace internal
+
+template <typename Key, typename T, typename Compare, typename Allocator>
+class TypeConvertor<std::map<Key, T, Compare, Allocator>>
+    : public internal::MapConvertor<std::map<Key, T, Compare, Allocator>> {};
+
+template <typename Key, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+class TypeConvertor<std::unordered_map<Key, T, Hash, KeyEqual, Allocator>>
+    : public internal::MapConvertor<
+          std::unordered_map<Key, T, Hash, KeyEqual, Allocator>> {};
+
+template <typename Key, typename Compare, typename Allocator>
+class TypeConvertor<std::set<Key, Compare, Allocator>>
+    : public internal::SetConvertor<std::set<Key, Compare, Allocator>> {};
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+class TypeConvertor<std::unordered_set<Key, Hash, KeyEqual, Allocator>>
+    : public internal::SetConvertor<
+          std::unordered_set<Key, Hash, KeyEqual, Allocator>> {};
+
+template <typename T>
+struct JSTypeOf<std::vector<T>> : JSTypes<napi_object> {};
+
+template <typename Key, typename T, typename Compare, typename Allocator>
+struct JSTypeOf<std::map<Key, T, Compare, Allocator>> : JSTypes<napi_object> {
+};
+
+template <typename Key, typename T, typename Hash, typename KeyEqual,
+          typename Allocator>
+struct JSTypeOf<std::unordered_map<Key, T, Hash, KeyEqual, Allocator>>
+    : JSTypes<napi_object> {};
+
+template <typename Key, typename Compare, typename Allocator>
+struct JSTypeOf<std::set<Key, Compare, Allocator>> : JSTypes<napi_object> {};
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+struct JSTypeOf<std::unordered_set<Key, Hash, KeyEqual, Allocator>>
+    : JSTypes<napi_object> {};
+
 }  // namespace node_binding
 
-#endif  // NODE_BINDING_STL_H_
\ No newline at end of file
+#endif  // NODE_BINDING_STL_H_
@@ -0,0 +1,476 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_TRACE_H_
+#define NODE_BINDING_TRACE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "node_binding/profile.h"
+
+#if defined(NODE_BINDING_PROFILING)
+#include <dlfcn.h>
+#include <stdlib.h>
+#endif
+
+namespace node_binding {
+
+// Heap allocations and N-API handles made by a thread, which are counted
+// only if NODE_BINDING_PROFILING is defined. See node_binding/profile.h.
+struct TraceCounters {
+#if defined(NODE_BINDING_PROFILING)
+  static TraceCounters Now() {
+    if (!node_binding_counters) return TraceCounters();
+    const NodeBindingCounters* counters = node_binding_counters();
+    return {counters->allocations, counters->bytes, counters->handles};
+  }
+
+  TraceCounters operator-(const TraceCounters& other) const {
+    return {allocations - other.allocations, bytes - other.bytes,
+            handles - other.handles};
+  }
+
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  uint64_t handles = 0;
+#else
+  static TraceCounters Now() { return TraceCounters(); }
+
+  TraceCounters operator-(const TraceCounters& other) const {
+    return TraceCounters();
+  }
+#endif
+};
+
+// A point in time, where a span begins or ends.
+struct TraceMark {
+  static TraceMark Now();
+
+  bool IsValid() const { return time >= 0; }
+
+  int64_t time = -1;
+  TraceCounters counters;
+};
+
+class Tracer;
+
+#if defined(NODE_BINDING_PROFILING)
+namespace internal {
+
+// Traces the addon if NODE_BINDING_PROFILE names a directory, and writes the
+// trace to <directory>/<addon>.<pid>.json at exit.
+class ProfileSession {
+ public:
+  static constexpr size_t kBufferSize = 1 << 18;
+
+  explicit ProfileSession(Tracer* tracer);
+  ~ProfileSession();
+
+ private:
+  Tracer* tracer_;
+  std::string path_;
+};
+
+}  // namespace internal
+#endif
+
+// Records spans of bound calls, finalizers and background tasks, and writes
+// them in the Chrome trace event format, which chrome://tracing and Perfetto
+// open. Spans are recorded only if NODE_BINDING_TRACING is defined, and
+// while the tracer is started.
+//
+//   Tracer::GetInstance().Start();
+//   ...
+//   Tracer::GetInstance().Flush("trace.json");
+//
+// Each thread records into its own ring buffer, which keeps its latest
+// |buffer_size()| spans.
+class Tracer {
+ public:
+  static constexpr size_t kDefaultBufferSize = 16384;
+
+  // It is never destroyed, since threads may record until exit.
+  static Tracer& GetInstance() {
+    static Tracer* tracer = new Tracer();
+#if defined(NODE_BINDING_PROFILING)
+    static internal::ProfileSession session(tracer);
+#endif
+    return *tracer;
+  }
+
+  Tracer(const Tracer& other) = delete;
+  Tracer& operator=(const Tracer& other) = delete;
+
+  // Returns nanoseconds of a monotonic clock.
+  static int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void Start() { enabled_.store(true, std::memory_order_relaxed); }
+  void Stop() { enabled_.store(false, std::memory_order_relaxed); }
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  size_t buffer_size() const {
+    return buffer_size_.load(std::memory_order_relaxed);
+  }
+
+  // Applies to buffers of threads which haven't recorded yet.
+  void set_buffer_size(size_t size) {
+    buffer_size_.store(size > 0 ? size : 1, std::memory_order_relaxed);
+  }
+
+  // Creates the buffer of the calling thread ahead, so that it isn't
+  // counted in a span.
+  void Prepare() { GetThreadBuffer(); }
+
+  // Records a span from |begin| to |end|. |name| and |detail| must be static
+  // strings, and |detail| may be nullptr.
+  void Record(const char* name, const char* detail, const TraceMark& begin,
+              const TraceMark& end) {
+    Buffer* buffer = GetThreadBuffer();
+    buffer->Lock();
+    buffer->events[buffer->next] = {name, detail, begin.time, end.time,
+                                    end.counters - begin.counters};
+    if (++buffer->next == buffer->events.size()) {
+      buffer->next = 0;
+      buffer->wrapped = true;
+    }
+    buffer->Unlock();
+  }
+
+  // Writes recorded spans to |path| and clears them. Returns false if it
+  // fails to write.
+  bool Flush(const std::string& path) {
+    std::vector<std::pair<uint32_t, std::vector<Event>>> threads;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto it = buffers_.begin(); it != buffers_.end();) {
+        Buffer* buffer = *it;
+        buffer->Lock();
+        threads.emplace_back(buffer->thread_id, buffer->Take());
+        bool retired = buffer->retired;
+        buffer->Unlock();
+        if (retired) {
+          delete buffer;
+          it = buffers_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+    fputs("{\"traceEvents\":[", file);
+    bool first = true;
+    for (const auto& thread : threads) {
+      for (const Event& event : thread.second) {
+        fprintf(file,
+                "%s\n{\"name\":\"%s\",\"cat\":\"node_binding\",\"ph\":\"X\","
+                "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u",
+                first ? "" : ",", event.name, event.begin / 1000.0,
+                (event.end - event.begin) / 1000.0, ProcessId(), thread.first);
+        fputs(",\"args\":{", file);
+        if (event.detail != nullptr) {
+          fputs("\"detail\":\"", file);
+          WriteEscaped(file, event.detail);
+          fputc('"', file);
+        }
+#if defined(NODE_BINDING_PROFILING)
+        fprintf(file,
+                "%s\"allocations\":%llu,\"bytes\":%llu,\"handles\":%llu",
+                event.detail != nullptr ? "," : "",
+                static_cast<unsigned long long>(event.counters.allocations),
+                static_cast<unsigned long long>(event.counters.bytes),
+                static_cast<unsigned long long>(event.counters.handles));
+#endif
+        fputs("}}", file);
+        first = false;
+      }
+    }
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+    return fclose(file) == 0;
+  }
+
+ private:
+  struct Event {
+    const char* name;
+    const char* detail;
+    int64_t begin;
+    int64_t end;
+    TraceCounters counters;
+  };
+
+  // Written by its thread, and read by Flush() on another, which is rare,
+  // so a spin lock is cheaper than a mutex.
+  struct Buffer {
+    void Lock() {
+      while (locked.test_and_set(std::memory_order_acquire)) {
+      }
+    }
+    void Unlock() { locked.clear(std::memory_order_release); }
+
+    // Returns the events in the order they were recorded, and clears them.
+    std::vector<Event> Take() {
+      std::vector<Event> taken;
+      if (wrapped) {
+        taken.insert(taken.end(), events.begin() + next, events.end());
+      }
+      taken.insert(taken.end(), events.begin(), events.begin() + next);
+      next = 0;
+      wrapped = false;
+      return taken;
+    }
+
+    std::atomic_flag locked = ATOMIC_FLAG_INIT;
+    std::vector<Event> events;
+    size_t next = 0;
+    bool wrapped = false;
+    // Set when its thread exits, so that Flush() deletes it.
+    bool retired = false;
+    uint32_t thread_id = 0;
+  };
+
+  // Retires the buffer of a thread when the thread exits.
+  struct ThreadBuffer {
+    ~ThreadBuffer() {
+      if (buffer == nullptr) return;
+      buffer->Lock();
+      buffer->retired = true;
+      buffer->Unlock();
+    }
+
+    Buffer* buffer = nullptr;
+  };
+
+  Tracer() = default;
+
+  static int ProcessId() {
+#if defined(_WIN32)
+    return _getpid();
+#else
+    return getpid();
+#endif
+  }
+
+  static void WriteEscaped(FILE* file, const char* text) {
+    for (; *text != '\0'; ++text) {
+      if (*text == '"' || *text == '\\') fputc('\\', file);
+      fputc(*text, file);
+    }
+  }
+
+  Buffer* GetThreadBuffer() {
+    thread_local ThreadBuffer thread_buffer;
+    if (thread_buffer.buffer == nullptr) {
+      Buffer* buffer = new Buffer();
+      buffer->events.resize(buffer_size());
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffer->thread_id = next_thread_id_++;
+      buffers_.push_back(buffer);
+      thread_buffer.buffer = buffer;
+    }
+    return thread_buffer.buffer;
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<size_t> buffer_size_{kDefaultBufferSize};
+  std::mutex mutex_;
+  std::vector<Buffer*> buffers_;
+  uint32_t next_thread_id_ = 1;
+};
+
+#if defined(NODE_BINDING_PROFILING)
+namespace internal {
+
+inline ProfileSession::ProfileSession(Tracer* tracer) : tracer_(tracer) {
+  const char* directory = getenv("NODE_BINDING_PROFILE");
+  if (directory == nullptr || *directory == '\0') return;
+
+  std::string name = "addon";
+  Dl_info info;
+  if (dladdr(reinterpret_cast<void*>(&Tracer::GetInstance), &info) &&
+      info.dli_fname != nullptr) {
+    name = info.dli_fname;
+    name = name.substr(name.find_last_of('/') + 1);
+  }
+  path_ = std::string(directory) + "/" + name + "." +
+          std::to_string(getpid()) + ".json";
+  tracer_->set_buffer_size(kBufferSize);
+  tracer_->Start();
+}
+
+inline ProfileSession::~ProfileSession() {
+  if (!path_.empty()) tracer_->Flush(path_);
+}
+
+}  // namespace internal
+#endif
+
+namespace internal {
+
+// Returns an invalid mark if the tracer is stopped.
+inline TraceMark BeginSpan() {
+  Tracer& tracer = Tracer::GetInstance();
+  if (!tracer.IsEnabled()) return TraceMark();
+  tracer.Prepare();
+  return TraceMark::Now();
+}
+
+}  // namespace internal
+
+inline TraceMark TraceMark::Now() {
+  TraceMark mark;
+  mark.time = Tracer::Now();
+  mark.counters = TraceCounters::Now();
+  return mark;
+}
+
+// Records a span from its construction to its destruction.
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name, const char* detail = nullptr)
+      : name_(name), detail_(detail), begin_(internal::BeginSpan()) {}
+  TraceScope(const TraceScope& other) = delete;
+  TraceScope& operator=(const TraceScope& other) = delete;
+
+  ~TraceScope() {
+    if (!begin_.IsValid()) return;
+    Tracer::GetInstance().Record(name_, detail_, begin_, TraceMark::Now());
+  }
+
+ private:
+  const char* name_;
+  const char* detail_;
+  TraceMark begin_;
+};
+
+namespace internal {
+
+// Records a bound call, splitting it into argument conversions, native
+// execution and result conversion. The native span runs from the end of
+// the last argument conversion, or of the argument checks, to the start of
+// the result conversion, or to the end of the call.
+class CallTrace {
+ public:
+  CallTrace(const char* name, const char* detail)
+      : scope_(name, detail), outer_(current()) {
+    current() = this;
+  }
+  CallTrace(const CallTrace& other) = delete;
+  CallTrace& operator=(const CallTrace& other) = delete;
+
+  ~CallTrace() {
+    EndNative();
+    current() = outer_;
+  }
+
+  static CallTrace*& current() {
+    thread_local CallTrace* current = nullptr;
+    return current;
+  }
+
+  // Called when arguments are checked or an argument is converted.
+  void Mark() { native_begin_ = BeginSpan(); }
+
+  void MarkAt(const TraceMark& mark) { native_begin_ = mark; }
+
+  void EndNative() {
+    if (!native_begin_.IsValid()) return;
+    Tracer::GetInstance().Record("Native", nullptr, native_begin_,
+                                 TraceMark::Now());
+    native_begin_ = TraceMark();
+  }
+
+ private:
+  TraceScope scope_;
+  CallTrace* outer_;
+  TraceMark native_begin_;
+};
+
+// Records the conversion of an argument of the current call.
+class ArgTrace {
+ public:
+  ArgTrace() : begin_(BeginSpan()) {}
+  ArgTrace(const ArgTrace& other) = delete;
+  ArgTrace& operator=(const ArgTrace& other) = delete;
+
+  ~ArgTrace() {
+    if (!begin_.IsValid()) return;
+    TraceMark end = TraceMark::Now();
+    Tracer::GetInstance().Record("ConvertArg", nullptr, begin_, end);
+    if (CallTrace::current()) CallTrace::current()->MarkAt(end);
+  }
+
+ private:
+  TraceMark begin_;
+};
+
+// Ends the native span of the current call when the result conversion
+// starts.
+class ResultTrace {
+ public:
+  ResultTrace() : scope_((EndNative(), "ConvertResult")) {}
+
+ private:
+  static void EndNative() {
+    if (CallTrace::current()) CallTrace::current()->EndNative();
+  }
+
+  TraceScope scope_;
+};
+
+}  // namespace internal
+
+}  // namespace node_binding
+
+#if defined(_MSC_VER)
+#define NODE_BINDING_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+#define NODE_BINDING_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+#define NODE_BINDING_TRACE_CONCAT_INNER(a, b) a##b
+#define NODE_BINDING_TRACE_CONCAT(a, b) NODE_BINDING_TRACE_CONCAT_INNER(a, b)
+
+#if defined(NODE_BINDING_TRACING)
+// Records a span of the enclosing scope, with the signature of the
+// enclosing function as its detail.
+#define NODE_BINDING_TRACE_SCOPE(name)                                   \
+  ::node_binding::TraceScope NODE_BINDING_TRACE_CONCAT(trace_scope_,     \
+                                                       __LINE__)(        \
+      name, NODE_BINDING_FUNCTION_SIGNATURE)
+#define NODE_BINDING_TRACE_CALL(name)                               \
+  ::node_binding::internal::CallTrace node_binding_call_trace(      \
+      name, NODE_BINDING_FUNCTION_SIGNATURE)
+#define NODE_BINDING_TRACE_ARGS_CHECKED() node_binding_call_trace.Mark()
+#define NODE_BINDING_TRACE_ARG() \
+  ::node_binding::internal::ArgTrace node_binding_arg_trace
+#define NODE_BINDING_TRACE_RESULT() \
+  ::node_binding::internal::ResultTrace node_binding_result_trace
+#else
+#define NODE_BINDING_TRACE_SCOPE(name)
+#define NODE_BINDING_TRACE_CALL(name)
+#define NODE_BINDING_TRACE_ARGS_CHECKED()
+#define NODE_BINDING_TRACE_ARG()
+#define NODE_BINDING_TRACE_RESULT()
+#endif
+
+#endif  // NODE_BINDING_TRACE_H_
@@ -0,0 +1,112 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_TRANSFER_H_
+#define NODE_BINDING_TRANSFER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace node_binding {
+
+// How a wrapped native object may be handed to another env, such as a
+// worker thread, without copying.
+enum class Transfer {
+  kNone,
+  // The object can be detached from its JS object and adopted by another
+  // env, which becomes its only owner.
+  kMove,
+  // Besides kMove, envs can own the object together. It is accessed from
+  // several threads at once, so it must be immutable or synchronize itself.
+  kShare,
+};
+
+// Specialize it to make a class bound by Class<T> transferable.
+//
+//   template <>
+//   struct TransferPolicy<Matrix> {
+//     static constexpr Transfer value = Transfer::kShare;
+//   };
+template <typename T, typename SFINAE = void>
+struct TransferPolicy {
+  static constexpr Transfer value = Transfer::kNone;
+};
+
+// Native objects in transit between envs, keyed by tokens which can be
+// posted to a worker as numbers. A token is taken once. Objects whose
+// tokens are never taken are kept until exit.
+//
+//   // On the sending thread.
+//   uint64_t token = TransferRegistry::GetInstance().Put(matrix);
+//   // On the receiving thread.
+//   std::shared_ptr<Matrix> matrix =
+//       TransferRegistry::GetInstance().Take<Matrix>(token);
+class TransferRegistry {
+ public:
+  // It is never destroyed, since objects left in it may depend on other
+  // singletons, such as the Reclaimer.
+  static TransferRegistry& GetInstance() {
+    static TransferRegistry* registry = new TransferRegistry();
+    return *registry;
+  }
+
+  TransferRegistry(const TransferRegistry& other) = delete;
+  TransferRegistry& operator=(const TransferRegistry& other) = delete;
+
+  template <typename T>
+  uint64_t Put(std::shared_ptr<T> object) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t token = next_token_++;
+    objects_.emplace(token, Entry{std::move(object), TypeId<T>()});
+    return token;
+  }
+
+  // Returns nullptr if |token| is unknown, already taken or of another
+  // type.
+  template <typename T>
+  std::shared_ptr<T> Take(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(token);
+    if (it == objects_.end() || it->second.type != TypeId<T>()) {
+      return nullptr;
+    }
+    std::shared_ptr<T> object =
+        std::static_pointer_cast<T>(std::move(it->second.object));
+    objects_.erase(it);
+    return object;
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return objects_.size();
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<void> object;
+    const void* type;
+  };
+
+  TransferRegistry() = default;
+
+  template <typename T>
+  static const void* TypeId() {
+    static const char id = 0;
+    return &id;
+  }
+
+  std::mutex mutex_;
+  // Tokens start from 1, so that 0 is never valid. They stay below 2^53 to
+  // be exact as JS numbers.
+  uint64_t next_token_ = 1;
+  std::unordered_map<uint64_t, Entry> objects_;
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_TRANSFER_H_
@@ -5,7 +5,17 @@
 #ifndef NODE_BINDING_TYPE_CONVERTOR_H_
 #define NODE_BINDING_TYPE_CONVERTOR_H_
 
+#include <stdint.h>
+
+#include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define NODE_BINDING_HAS_STRING_VIEW
+#endif
 
 #include "napi.h"
 
@@ -25,8 +35,12 @@ class TypeConvertor<bool> {
     return value.IsBoolean();
   }
 
+  static Napi::Value ToJSValue(Napi::Env env, bool value) {
+    return Napi::Boolean::New(env, value);
+  }
+
   static Napi::Value ToJSValue(const Napi::CallbackInfo& info, bool value) {
-    return Napi::Boolean::New(info.Env(), value);
+    return ToJSValue(info.Env(), value);
   }
 };
 
@@ -43,8 +57,12 @@ class TypeConvertor<T, std::enable_if_t<std::is_integral<T>::value &&
     return value.IsNumber();
   }
 
+  static Napi::Value ToJSValue(Napi::Env env, T value) {
+    return Napi::Number::New(env, value);
+  }
+
   static Napi::Value ToJSValue(const Napi::CallbackInfo& info, T value) {
-    return Napi::Number::New(info.Env(), value);
+    return ToJSValue(info.Env(), value);
   }
 };
 
@@ -62,8 +80,12 @@ class TypeConvertor<
     return value.IsNumber();
   }
 
+  static Napi::Value ToJSValue(Napi::Env env, T value) {
+    return Napi::Number::New(env, value);
+  }
+
   static Napi::Value ToJSValue(const Napi::CallbackInfo& info, T value) {
-    return Napi::Number::New(info.Env(), value);
+    return ToJSValue(info.Env(), value);
   }
 };
 
@@ -86,13 +108,17 @@ class TypeConvertor<T, std::enable_if_t<std::is_same<int64_t, T>::value>> {
 #endif
   }
 
-  static Napi::Value ToJSValue(const Napi::CallbackInfo& info, int64_t value) {
+  static Napi::Value ToJSValue(Napi::Env env, int64_t value) {
 #ifdef NAPI_EXPERIMENTAL
-    return Napi::BigInt::New(info.Env(), value);
+    return Napi::BigInt::New(env, value);
 #else
-    return Napi::Number::New(info.Env(), value);
+    return Napi::Number::New(env, value);
 #endif
   }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info, int64_t value) {
+    return ToJSValue(info.Env(), value);
+  }
 };
 
 template <typename T>
@@ -114,13 +140,17 @@ class TypeConvertor<T, std::enable_if_t<std::is_same<uint64_t, T>::value>> {
 #endif
   }
 
-  static Napi::Value ToJSValue(const Napi::CallbackInfo& info, uint64_t value) {
+  static Napi::Value ToJSValue(Napi::Env env, uint64_t value) {
 #ifdef NAPI_EXPERIMENTAL
-    return Napi::BigInt::New(info.Env(), value);
+    return Napi::BigInt::New(env, value);
 #else
-    return Napi::Number::New(info.Env(), value);
+    return Napi::Number::New(env, value);
 #endif
   }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info, uint64_t value) {
+    return ToJSValue(info.Env(), value);
+  }
 };
 
 template <typename T>
@@ -134,8 +164,12 @@ class TypeConvertor<T, std::enable_if_t<std::is_same<float, T>::value>> {
     return value.IsNumber();
   }
 
+  static Napi::Value ToJSValue(Napi::Env env, float value) {
+    return Napi::Number::New(env, value);
+  }
+
   static Napi::Value ToJSValue(const Napi::CallbackInfo& info, float value) {
-    return Napi::Number::New(info.Env(), value);
+    return ToJSValue(info.Env(), value);
   }
 };
 
@@ -150,8 +184,12 @@ class TypeConvertor<T, std::enable_if_t<std::is_same<double, T>::value>> {
     return value.IsNumber();
   }
 
+  static Napi::Value ToJSValue(Napi::Env env, double value) {
+    return Napi::Number::New(env, value);
+  }
+
   static Napi::Value ToJSValue(const Napi::CallbackInfo& info, double value) {
-    return Napi::Number::New(info.Env(), value);
+    return ToJSValue(info.Env(), value);
   }
 };
 
@@ -166,12 +204,124 @@ class TypeConvertor<T, std::enable_if_t<std::is_same<std::string, T>::value>> {
     return value.IsString();
   }
 
+  static Napi::Value ToJSValue(Napi::Env env, const std::string& value) {
+    return Napi::String::New(env, value);
+  }
+
   static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
                                const std::string& value) {
-    return Napi::String::New(info.Env(), value);
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+// Converts JS strings by their UTF-16 accessors, without transcoding.
+template <typename T>
+class TypeConvertor<T,
+                    std::enable_if_t<std::is_same<std::u16string, T>::value>> {
+ public:
+  static std::u16string ToNativeValue(const Napi::Value& value) {
+    size_t length;
+    napi_get_value_string_utf16(value.Env(), value, nullptr, 0, &length);
+    std::u16string native(length, u'\0');
+    napi_get_value_string_utf16(value.Env(), value, &native[0], length + 1,
+                                &length);
+    return native;
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return value.IsString();
+  }
+
+  static Napi::Value ToJSValue(Napi::Env env, const std::u16string& value) {
+    return Napi::String::New(env, value.data(), value.size());
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const std::u16string& value) {
+    return ToJSValue(info.Env(), value);
   }
 };
 
+#ifdef NODE_BINDING_HAS_STRING_VIEW
+
+namespace internal {
+
+// A buffer of UTF-16 code units, which is taken from a free list of the
+// thread and given back when destroyed, so that decoding strings reuses
+// memory across calls.
+class Utf16Buffer {
+ public:
+  // Buffers which grew larger are freed instead of kept.
+  static constexpr size_t kMaxKeptSize = 64 * 1024;
+
+  Utf16Buffer() {
+    std::vector<std::u16string>& free_list = FreeList();
+    if (!free_list.empty()) {
+      buffer_ = std::move(free_list.back());
+      free_list.pop_back();
+    }
+  }
+
+  ~Utf16Buffer() {
+    if (buffer_.capacity() == 0 || buffer_.capacity() > kMaxKeptSize) return;
+    FreeList().push_back(std::move(buffer_));
+  }
+
+  Utf16Buffer(const Utf16Buffer& other) = delete;
+  Utf16Buffer& operator=(const Utf16Buffer& other) = delete;
+
+  // Decodes |value|, which is a JS string, into this. The result is valid
+  // until this is destroyed or decodes another string.
+  std::u16string_view Decode(const Napi::Value& value) {
+    size_t length;
+    napi_get_value_string_utf16(value.Env(), value, nullptr, 0, &length);
+    if (buffer_.size() < length) buffer_.resize(length);
+    napi_get_value_string_utf16(value.Env(), value, &buffer_[0],
+                                buffer_.size() + 1, &length);
+    return std::u16string_view(buffer_.data(), length);
+  }
+
+ private:
+  static std::vector<std::u16string>& FreeList() {
+    thread_local std::vector<std::u16string> free_list;
+    return free_list;
+  }
+
+  std::u16string buffer_;
+};
+
+}  // namespace internal
+
+// Converts a JS string argument into a view of a reusable buffer, which is
+// valid until the bound call returns. Only arguments can be converted, since
+// the view needs the buffer, see ArgStorage in node_binding/arg_type_checker.h.
+template <typename T>
+class TypeConvertor<
+    T, std::enable_if_t<std::is_same<std::u16string_view, T>::value>> {
+ public:
+  using ArgStorage = internal::Utf16Buffer;
+
+  static std::u16string_view ToNativeValue(const Napi::Value& value,
+                                           ArgStorage* storage) {
+    return storage->Decode(value);
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return value.IsString();
+  }
+
+  static Napi::Value ToJSValue(Napi::Env env, std::u16string_view value) {
+    return Napi::String::New(env, value.data(), value.size());
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               std::u16string_view value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+#endif  // NODE_BINDING_HAS_STRING_VIEW
+
 template <typename T>
 class TypeConvertor<T, std::enable_if_t<std::is_enum<T>::value>> {
  public:
@@ -183,12 +333,121 @@ class TypeConvertor<T, std::enable_if_t<std::is_enum<T>::value>> {
     return value.IsNumber();
   }
 
-  static Napi::Value ToJSValue(const Napi::CallbackInfo& info, T value) {
-    return Napi::Number::New(info.Env(),
+  static Napi::Value ToJSValue(Napi::Env env, T value) {
+    return Napi::Number::New(env,
                              static_cast<std::underlying_type_t<T>>(value));
   }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info, T value) {
+    return ToJSValue(info.Env(), value);
+  }
 };
 
+namespace internal {
+
+constexpr uint32_t JSTypeMask() { return 0; }
+
+template <typename... Rest>
+constexpr uint32_t JSTypeMask(napi_valuetype type, Rest... rest) {
+  return (1u << type) | JSTypeMask(rest...);
+}
+
+}  // namespace internal
+
+template <napi_valuetype... Types>
+struct JSTypes {
+  static constexpr uint32_t kTypes = internal::JSTypeMask(Types...);
+  static constexpr bool kExact = false;
+};
+
+template <napi_valuetype... Types>
+struct ExactJSTypes : JSTypes<Types...> {
+  static constexpr bool kExact = true;
+};
+
+// The JS types, by napi_valuetype, which TypeConvertor<T> takes. A
+// std::variant picks its alternative by them with a single napi_typeof,
+// instead of probing each alternative, see node_binding/variant.h. If
+// |kExact|, every value of these types is convertible, so IsConvertible() is
+// skipped too. Unknown types may take any JS type. Specialize it for your
+// own convertors.
+//
+//   template <>
+//   struct JSTypeOf<Point> : JSTypes<napi_object> {};
+template <typename T, typename SFINAE = void>
+struct JSTypeOf
+    : JSTypes<napi_undefined, napi_null, napi_boolean, napi_number,
+              napi_string, napi_symbol, napi_object, napi_function,
+              napi_external, napi_bigint> {};
+
+template <>
+struct JSTypeOf<bool> : ExactJSTypes<napi_boolean> {};
+
+template <typename T>
+struct JSTypeOf<T, std::enable_if_t<(std::is_arithmetic<T>::value &&
+                                     !std::is_same<bool, T>::value &&
+                                     !std::is_same<int64_t, T>::value &&
+                                     !std::is_same<uint64_t, T>::value) ||
+                                    std::is_enum<T>::value>>
+    : ExactJSTypes<napi_number> {};
+
+template <typename T>
+struct JSTypeOf<T, std::enable_if_t<std::is_same<int64_t, T>::value ||
+                                    std::is_same<uint64_t, T>::value>>
+#ifdef NAPI_EXPERIMENTAL
+    : ExactJSTypes<napi_bigint> {
+};
+#else
+    : ExactJSTypes<napi_number> {
+};
+#endif
+
+template <>
+struct JSTypeOf<std::string> : ExactJSTypes<napi_string> {};
+
+template <>
+struct JSTypeOf<std::u16string> : ExactJSTypes<napi_string> {};
+
+namespace internal {
+
+// True if TypeConvertor<T> defines
+//
+//   static bool TryToNativeValue(const Napi::Value& value, T* out);
+//
+// which checks and converts |value| in one pass, and returns false if it
+// isn't convertible. Containers define it, so that each element is fetched
+// from V8 once instead of once by IsConvertible() and again by
+// ToNativeValue(). It is used only if T is default constructible.
+template <typename T, typename SFINAE = void>
+struct HasTryToNativeValue : std::false_type {};
+
+template <typename T>
+struct HasTryToNativeValue<
+    T, decltype(void(TypeConvertor<T>::TryToNativeValue(
+           std::declval<const Napi::Value&>(), std::declval<T*>())))>
+    : std::is_default_constructible<T> {};
+
+// Checks and converts |value| by TypeConvertor<T>, and passes the result to
+// |emplace|. Returns false without calling it if |value| isn't convertible.
+template <typename T, typename Emplace>
+std::enable_if_t<HasTryToNativeValue<T>::value, bool> TryConvert(
+    const Napi::Value& value, Emplace&& emplace) {
+  T native;
+  if (!TypeConvertor<T>::TryToNativeValue(value, &native)) return false;
+  emplace(std::move(native));
+  return true;
+}
+
+template <typename T, typename Emplace>
+std::enable_if_t<!HasTryToNativeValue<T>::value, bool> TryConvert(
+    const Napi::Value& value, Emplace&& emplace) {
+  if (!TypeConvertor<T>::IsConvertible(value)) return false;
+  emplace(TypeConvertor<T>::ToNativeValue(value));
+  return true;
+}
+
+}  // namespace internal
+
 template <typename T>
 auto ToNativeValue(const Napi::Value& value) {
   return TypeConvertor<T>::ToNativeValue(value);
@@ -205,6 +464,25 @@ Napi::Value ToJSValue(const Napi::CallbackInfo& info, T&& value) {
                                                    std::forward<T>(value));
 }
 
+template <typename T>
+Napi::Value ToJSValue(Napi::Env env, T&& value) {
+  return TypeConvertor<std::decay_t<T>>::ToJSValue(env, std::forward<T>(value));
+}
+
+namespace internal {
+
+// True if TypeConvertor<T> can convert a |T| without Napi::CallbackInfo.
+template <typename T, typename SFINAE = void>
+struct HasEnvToJSValue : std::false_type {};
+
+template <typename T>
+struct HasEnvToJSValue<T, decltype(void(TypeConvertor<T>::ToJSValue(
+                              std::declval<Napi::Env>(),
+                              std::declval<const T&>())))> : std::true_type {
+};
+
+}  // namespace internal
+
 }  // namespace node_binding
 
 #endif  // NODE_BINDING_TYPE_CONVERTOR_H_
\ No newline at end of file
@@ -5,6 +5,7 @@
 #ifndef NODE_BINDING_TYPED_CALL_H_
 #define NODE_BINDING_TYPED_CALL_H_
 
+#include <tuple>
 #include <utility>
 
 #include "napi.h"
@@ -17,145 +18,181 @@ namespace node_binding {
 
 namespace internal {
 
-template <size_t Idx, typename ArgList>
-auto Arg(const Napi::CallbackInfo& info) {
-  return TypeConvertor<internal::PickTypeListItem<Idx, ArgList>>::ToNativeValue(
-      info[Idx]);
+template <size_t Idx, typename ArgList, typename Slots>
+decltype(auto) Arg(const Napi::CallbackInfo& info, Slots* slots) {
+  NODE_BINDING_TRACE_ARG();
+  return TakeArg<PickTypeListItem<Idx, ArgList>>(info[Idx],
+                                                  &std::get<Idx>(*slots));
 }
 
-template <typename R, typename... Args, size_t... Indices,
+// Converts the result of a bound call, which is traced apart from the call.
+template <typename T>
+Napi::Value CallResult(const Napi::CallbackInfo& info, T&& value) {
+  NODE_BINDING_TRACE_RESULT();
+  return ToJSValue(info, std::forward<T>(value));
+}
+
+template <typename Slots, typename R, typename... Args, size_t... Indices,
           typename... DefaultArgs>
-R Invoke(const Napi::CallbackInfo& info, R (*f)(Args...),
+R Invoke(const Napi::CallbackInfo& info, Slots* slots, R (*f)(Args...),
          std::index_sequence<Indices...>, DefaultArgs&&... def_args) {
   using ArgList = internal::TypeList<Args...>;
-  return f(Arg<Indices, ArgList>(info)...,
+  (void)slots;
+  return f(Arg<Indices, ArgList>(info, slots)...,
            std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, size_t... Indices,
-          typename... DefaultArgs>
-R Invoke(const Napi::CallbackInfo& info, R (Class::*f)(Args...), Class* c,
-         std::index_sequence<Indices...>, DefaultArgs&&... def_args) {
+template <typename Slots, typename R, typename Class, typename... Args,
+          size_t... Indices, typename... DefaultArgs>
+R Invoke(const Napi::CallbackInfo& info, Slots* slots, R (Class::*f)(Args...),
+         Class* c, std::index_sequence<Indices...>,
+         DefaultArgs&&... def_args) {
   using ArgList = internal::TypeList<Args...>;
-  return ((*c).*f)(Arg<Indices, ArgList>(info)...,
+  (void)slots;
+  return ((*c).*f)(Arg<Indices, ArgList>(info, slots)...,
                    std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, size_t... Indices,
-          typename... DefaultArgs>
-R Invoke(const Napi::CallbackInfo& info, R (Class::*f)(Args...) const,
-         const Class* c, std::index_sequence<Indices...>,
+template <typename Slots, typename R, typename Class, typename... Args,
+          size_t... Indices, typename... DefaultArgs>
+R Invoke(const Napi::CallbackInfo& info, Slots* slots,
+         R (Class::*f)(Args...) const, const Class* c,
+         std::index_sequence<Indices...>,
          DefaultArgs&&... def_args) {
   using ArgList = internal::TypeList<Args...>;
-  return ((*c).*f)(Arg<Indices, ArgList>(info)...,
+  (void)slots;
+  return ((*c).*f)(Arg<Indices, ArgList>(info, slots)...,
                    std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, size_t... Indices,
-          typename... DefaultArgs>
-R Invoke(const Napi::CallbackInfo& info, R (Class::*f)(Args...) const&,
-         const Class* c, std::index_sequence<Indices...>,
+template <typename Slots, typename R, typename Class, typename... Args,
+          size_t... Indices, typename... DefaultArgs>
+R Invoke(const Napi::CallbackInfo& info, Slots* slots,
+         R (Class::*f)(Args...) const&, const Class* c,
+         std::index_sequence<Indices...>,
          DefaultArgs&&... def_args) {
   using ArgList = internal::TypeList<Args...>;
-  return ((*c).*f)(Arg<Indices, ArgList>(info)...,
+  (void)slots;
+  return ((*c).*f)(Arg<Indices, ArgList>(info, slots)...,
                    std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, size_t... Indices,
-          typename... DefaultArgs>
-R Invoke(const Napi::CallbackInfo& info, R (Class::*f)(Args...) &&, Class* c,
-         std::index_sequence<Indices...>, DefaultArgs&&... def_args) {
+template <typename Slots, typename R, typename Class, typename... Args,
+          size_t... Indices, typename... DefaultArgs>
+R Invoke(const Napi::CallbackInfo& info, Slots* slots,
+         R (Class::*f)(Args...) &&, Class* c, std::index_sequence<Indices...>,
+         DefaultArgs&&... def_args) {
   using ArgList = internal::TypeList<Args...>;
-  return (std::move(*c).*f)(Arg<Indices, ArgList>(info)...,
+  (void)slots;
+  return (std::move(*c).*f)(Arg<Indices, ArgList>(info, slots)...,
                             std::forward<DefaultArgs>(def_args)...);
 }
 
 }  // namespace internal
 
-template <typename R, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename R, typename... Args,
+          typename... DefaultArgs>
 Napi::Value TypedCall(const Napi::CallbackInfo& info, R (*f)(Args...),
                       DefaultArgs&&... def_args) {
   RETURN_UNDEFINED_IF_FAILED_TO_CHECK_ARGS();
-  return ToJSValue(
-      info, internal::Invoke(info, f, std::make_index_sequence<num_args>(),
+  return internal::CallResult(
+      info, internal::Invoke(info, &arg_slots, f,
+                             std::make_index_sequence<num_args>(),
                              std::forward<DefaultArgs>(def_args)...));
 }
 
-template <typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename... Args,
+          typename... DefaultArgs>
 void TypedCall(const Napi::CallbackInfo& info, void (*f)(Args...),
                DefaultArgs&&... def_args) {
   RETURN_IF_FAILED_TO_CHECK_ARGS();
-  internal::Invoke(info, f, std::make_index_sequence<num_args>(),
+  internal::Invoke(info, &arg_slots, f, std::make_index_sequence<num_args>(),
                    std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename R, typename Class,
+          typename... Args, typename... DefaultArgs>
 Napi::Value TypedCall(const Napi::CallbackInfo& info, R (Class::*f)(Args...),
                       Class* c, DefaultArgs&&... def_args) {
   RETURN_UNDEFINED_IF_FAILED_TO_CHECK_ARGS();
-  return ToJSValue(
-      info, internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  return internal::CallResult(
+      info, internal::Invoke(info, &arg_slots, f, c,
+                             std::make_index_sequence<num_args>(),
                              std::forward<DefaultArgs>(def_args)...));
 }
 
-template <typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename Class, typename... Args,
+          typename... DefaultArgs>
 void TypedCall(const Napi::CallbackInfo& info, void (Class::*f)(Args...),
                Class* c, DefaultArgs&&... def_args) {
   RETURN_IF_FAILED_TO_CHECK_ARGS();
-  internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  internal::Invoke(info, &arg_slots, f, c,
+                   std::make_index_sequence<num_args>(),
                    std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename R, typename Class,
+          typename... Args, typename... DefaultArgs>
 Napi::Value TypedCall(const Napi::CallbackInfo& info,
                       R (Class::*f)(Args...) const, const Class* c,
                       DefaultArgs&&... def_args) {
   RETURN_UNDEFINED_IF_FAILED_TO_CHECK_ARGS();
-  return ToJSValue(
-      info, internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  return internal::CallResult(
+      info, internal::Invoke(info, &arg_slots, f, c,
+                             std::make_index_sequence<num_args>(),
                              std::forward<DefaultArgs>(def_args)...));
 }
 
-template <typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename Class, typename... Args,
+          typename... DefaultArgs>
 void TypedCall(const Napi::CallbackInfo& info, void (Class::*f)(Args...) const,
                const Class* c, DefaultArgs&&... def_args) {
   RETURN_IF_FAILED_TO_CHECK_ARGS();
-  internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  internal::Invoke(info, &arg_slots, f, c,
+                   std::make_index_sequence<num_args>(),
                    std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename R, typename Class,
+          typename... Args, typename... DefaultArgs>
 Napi::Value TypedCall(const Napi::CallbackInfo& info,
                       R (Class::*f)(Args...) const&, const Class* c,
                       DefaultArgs&&... def_args) {
   RETURN_UNDEFINED_IF_FAILED_TO_CHECK_ARGS();
-  return ToJSValue(
-      info, internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  return internal::CallResult(
+      info, internal::Invoke(info, &arg_slots, f, c,
+                             std::make_index_sequence<num_args>(),
                              std::forward<DefaultArgs>(def_args)...));
 }
 
-template <typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename Class, typename... Args,
+          typename... DefaultArgs>
 void TypedCall(const Napi::CallbackInfo& info, void (Class::*f)(Args...) const&,
                const Class* c, DefaultArgs&&... def_args) {
   RETURN_IF_FAILED_TO_CHECK_ARGS();
-  internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  internal::Invoke(info, &arg_slots, f, c,
+                   std::make_index_sequence<num_args>(),
                    std::forward<DefaultArgs>(def_args)...);
 }
 
-template <typename R, typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename R, typename Class,
+          typename... Args, typename... DefaultArgs>
 Napi::Value TypedCall(const Napi::CallbackInfo& info, R (Class::*f)(Args...) &&,
                       Class* c, DefaultArgs&&... def_args) {
   RETURN_UNDEFINED_IF_FAILED_TO_CHECK_ARGS();
-  return ToJSValue(
-      info, internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  return internal::CallResult(
+      info, internal::Invoke(info, &arg_slots, f, c,
+                             std::make_index_sequence<num_args>(),
                              std::forward<DefaultArgs>(def_args)...));
 }
 
-template <typename Class, typename... Args, typename... DefaultArgs>
+template <typename Policy = StrictArgs, typename Class, typename... Args,
+          typename... DefaultArgs>
 void TypedCall(const Napi::CallbackInfo& info, void (Class::*f)(Args...) &&,
                Class* c, DefaultArgs&&... def_args) {
   RETURN_IF_FAILED_TO_CHECK_ARGS();
-  internal::Invoke(info, f, c, std::make_index_sequence<num_args>(),
+  internal::Invoke(info, &arg_slots, f, c,
+                   std::make_index_sequence<num_args>(),
                    std::forward<DefaultArgs>(def_args)...);
 }
 
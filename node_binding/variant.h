@@ -0,0 +1,301 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NODE_BINDING_VARIANT_H_
+#define NODE_BINDING_VARIANT_H_
+
+#if __cplusplus < 201703L && (!defined(_MSVC_LANG) || _MSVC_LANG < 201703L)
+#error "node_binding/variant.h requires C++17."
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "napi.h"
+#include "node_binding/type_convertor.h"
+
+namespace node_binding {
+
+namespace internal {
+
+inline napi_valuetype TypeOf(const Napi::Value& value) {
+  napi_valuetype type = napi_undefined;
+  napi_typeof(value.Env(), value, &type);
+  return type;
+}
+
+// Converts |value|, whose typeof is |type|, by TypeConvertor<T>, and passes
+// the result to |emplace|. Types out of JSTypeOf<T> are rejected without
+// asking TypeConvertor<T>.
+template <typename T, typename Emplace>
+bool TryConvertTypeOf(const Napi::Value& value, napi_valuetype type,
+                      Emplace&& emplace) {
+  if ((JSTypeOf<T>::kTypes & (1u << type)) == 0) return false;
+  if constexpr (JSTypeOf<T>::kExact) {
+    emplace(TypeConvertor<T>::ToNativeValue(value));
+    return true;
+  } else {
+    return TryConvert<T>(value, std::forward<Emplace>(emplace));
+  }
+}
+
+template <typename T>
+bool IsConvertibleTypeOf(const Napi::Value& value, napi_valuetype type) {
+  if ((JSTypeOf<T>::kTypes & (1u << type)) == 0) return false;
+  if constexpr (JSTypeOf<T>::kExact) {
+    return true;
+  } else {
+    return TypeConvertor<T>::IsConvertible(value);
+  }
+}
+
+// Returns |Variant| holding its first default constructible alternative.
+template <typename Variant, size_t I = 0>
+Variant DefaultVariant() {
+  static_assert(I < std::variant_size_v<Variant>,
+                "A variant needs a default constructible alternative.");
+  if constexpr (std::is_default_constructible_v<
+                    std::variant_alternative_t<I, Variant>>) {
+    return Variant(std::in_place_index<I>);
+  } else {
+    return DefaultVariant<Variant, I + 1>();
+  }
+}
+
+template <size_t I, typename Variant, typename Native>
+void EmplaceVariant(Variant* out, Native&& native) {
+  out->template emplace<I>(std::forward<Native>(native));
+}
+
+template <size_t I, typename Variant, typename Native>
+void EmplaceVariant(std::optional<Variant>* out, Native&& native) {
+  out->emplace(std::in_place_index<I>, std::forward<Native>(native));
+}
+
+// Converts |value| of typeof |Type| into the first alternative of |Variant|,
+// from the |I|th on, which takes it. Alternatives which don't take |Type|
+// are skipped at compile time.
+template <typename Variant, napi_valuetype Type, size_t I, typename Out>
+bool ConvertVariantAs(const Napi::Value& value, Out* out) {
+  if constexpr (I == std::variant_size_v<Variant>) {
+    return false;
+  } else {
+    using T = std::variant_alternative_t<I, Variant>;
+    if constexpr ((JSTypeOf<T>::kTypes & (1u << Type)) == 0) {
+      return ConvertVariantAs<Variant, Type, I + 1>(value, out);
+    } else {
+      auto emplace = [out](auto&& native) {
+        EmplaceVariant<I>(out, std::forward<decltype(native)>(native));
+      };
+      if (TryConvertTypeOf<T>(value, Type, emplace)) return true;
+      if constexpr (JSTypeOf<T>::kExact) {
+        return false;
+      } else {
+        return ConvertVariantAs<Variant, Type, I + 1>(value, out);
+      }
+    }
+  }
+}
+
+template <typename Variant, napi_valuetype Type, size_t I>
+bool IsVariantConvertibleAs(const Napi::Value& value) {
+  if constexpr (I == std::variant_size_v<Variant>) {
+    return false;
+  } else {
+    using T = std::variant_alternative_t<I, Variant>;
+    return IsConvertibleTypeOf<T>(value, Type) ||
+           IsVariantConvertibleAs<Variant, Type, I + 1>(value);
+  }
+}
+
+constexpr size_t kNumJSTypes = napi_bigint + 1;
+
+template <typename Variant, typename Out, size_t... Types>
+constexpr std::array<bool (*)(const Napi::Value&, Out*), sizeof...(Types)>
+MakeVariantConvertors(std::index_sequence<Types...>) {
+  return {{&ConvertVariantAs<Variant, static_cast<napi_valuetype>(Types), 0,
+                             Out>...}};
+}
+
+template <typename Variant, size_t... Types>
+constexpr std::array<bool (*)(const Napi::Value&), sizeof...(Types)>
+MakeVariantCheckers(std::index_sequence<Types...>) {
+  return {{&IsVariantConvertibleAs<Variant,
+                                   static_cast<napi_valuetype>(Types), 0>...}};
+}
+
+// Converters of |Variant| by typeof, which is classified once per value.
+template <typename Variant, typename Out>
+inline constexpr auto kVariantConvertors = MakeVariantConvertors<Variant, Out>(
+    std::make_index_sequence<kNumJSTypes>());
+
+template <typename Variant>
+inline constexpr auto kVariantCheckers =
+    MakeVariantCheckers<Variant>(std::make_index_sequence<kNumJSTypes>());
+
+}  // namespace internal
+
+// Converts undefined and null into std::monostate, and back into undefined.
+template <>
+class TypeConvertor<std::monostate> {
+ public:
+  static std::monostate ToNativeValue(const Napi::Value& value) { return {}; }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return value.IsUndefined() || value.IsNull();
+  }
+
+  static Napi::Value ToJSValue(Napi::Env env, std::monostate value) {
+    return env.Undefined();
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               std::monostate value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+// Converts undefined and null into std::nullopt, and std::nullopt back into
+// undefined.
+template <typename T>
+class TypeConvertor<std::optional<T>> {
+ public:
+  static bool TryToNativeValue(const Napi::Value& value,
+                               std::optional<T>* out) {
+    napi_valuetype type = internal::TypeOf(value);
+    if (type == napi_undefined || type == napi_null) {
+      out->reset();
+      return true;
+    }
+    return internal::TryConvertTypeOf<T>(value, type, [out](auto&& native) {
+      out->emplace(std::forward<decltype(native)>(native));
+    });
+  }
+
+  static std::optional<T> ToNativeValue(const Napi::Value& value) {
+    std::optional<T> native;
+    TryToNativeValue(value, &native);
+    return native;
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    napi_valuetype type = internal::TypeOf(value);
+    return type == napi_undefined || type == napi_null ||
+           internal::IsConvertibleTypeOf<T>(value, type);
+  }
+
+  // Only available if TypeConvertor<T> can convert without
+  // Napi::CallbackInfo.
+  template <typename U = T>
+  static std::enable_if_t<internal::HasEnvToJSValue<U>::value, Napi::Value>
+  ToJSValue(Napi::Env env, const std::optional<T>& value) {
+    if (!value) return env.Undefined();
+    return TypeConvertor<T>::ToJSValue(env, *value);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const std::optional<T>& value) {
+    if (!value) return info.Env().Undefined();
+    return TypeConvertor<T>::ToJSValue(info, *value);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               std::optional<T>&& value) {
+    if (!value) return info.Env().Undefined();
+    return TypeConvertor<T>::ToJSValue(info, std::move(*value));
+  }
+};
+
+// Converts a JS value into the first alternative which takes it. The typeof
+// of the value is taken once, and picks a converter from a table built at
+// compile time, which only tries the alternatives whose JSTypeOf includes
+// it. So order alternatives from the most specific, e.g. int32_t before
+// double would truncate every number.
+template <typename... Ts>
+class TypeConvertor<std::variant<Ts...>> {
+ public:
+  using Variant = std::variant<Ts...>;
+
+  static bool TryToNativeValue(const Napi::Value& value, Variant* out) {
+    return internal::kVariantConvertors<Variant, Variant>[internal::TypeOf(
+        value)](value, out);
+  }
+
+  static Variant ToNativeValue(const Napi::Value& value) {
+    std::optional<Variant> native;
+    internal::kVariantConvertors<Variant, std::optional<Variant>>
+        [internal::TypeOf(value)](value, &native);
+    if (native) return std::move(*native);
+    // Unchecked, e.g. by TrustedArgs, and no alternative takes |value|.
+    if (!value.Env().IsExceptionPending()) {
+      Napi::TypeError::New(value.Env(), "Type of value is mismatched")
+          .ThrowAsJavaScriptException();
+    }
+    return internal::DefaultVariant<Variant>();
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return internal::kVariantCheckers<Variant>[internal::TypeOf(value)](
+        value);
+  }
+
+  // Only available if all of TypeConvertor<Ts> can convert without
+  // Napi::CallbackInfo.
+  template <bool kEnv = (internal::HasEnvToJSValue<Ts>::value && ...)>
+  static std::enable_if_t<kEnv, Napi::Value> ToJSValue(Napi::Env env,
+                                                       const Variant& value) {
+    return std::visit(
+        [env](const auto& native) {
+          return TypeConvertor<std::decay_t<decltype(native)>>::ToJSValue(
+              env, native);
+        },
+        value);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Variant& value) {
+    return std::visit(
+        [&info](const auto& native) {
+          return TypeConvertor<std::decay_t<decltype(native)>>::ToJSValue(
+              info, native);
+        },
+        value);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               Variant&& value) {
+    return std::visit(
+        [&info](auto&& native) {
+          return TypeConvertor<std::decay_t<decltype(native)>>::ToJSValue(
+              info, std::forward<decltype(native)>(native));
+        },
+        std::move(value));
+  }
+};
+
+template <>
+struct JSTypeOf<std::monostate> : ExactJSTypes<napi_undefined, napi_null> {};
+
+template <typename T>
+struct JSTypeOf<std::optional<T>> {
+  static constexpr uint32_t kTypes = JSTypeOf<T>::kTypes |
+                                     JSTypeOf<std::monostate>::kTypes;
+  static constexpr bool kExact = JSTypeOf<T>::kExact;
+};
+
+template <typename... Ts>
+struct JSTypeOf<std::variant<Ts...>> {
+  static constexpr uint32_t kTypes = (JSTypeOf<Ts>::kTypes | ...);
+  static constexpr bool kExact = (JSTypeOf<Ts>::kExact && ...);
+};
+
+}  // namespace node_binding
+
+#endif  // NODE_BINDING_VARIANT_H_
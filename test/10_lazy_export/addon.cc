@@ -0,0 +1,53 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+
+#include "point.h"
+
+#include "node_binding/class.h"
+#include "node_binding/lazy_export.h"
+#include "node_binding/raw_call.h"
+
+using node_binding::Class;
+using node_binding::LazyExport;
+using node_binding::NewRawFunction;
+
+std::atomic<int> g_num_definitions(0);
+
+int NumDefinitions() { return g_num_definitions; }
+
+int CAdd(int a, int b) { return a + b; }
+
+LazyExport point_class("Point", [](Napi::Env env) -> Napi::Value {
+  ++g_num_definitions;
+  return Class<Point>("Point")
+      .Constructor<>()
+      .Constructor<int, int>()
+      .Field("x", NODE_BINDING_MEMBER(&Point::x))
+      .Field("y", NODE_BINDING_MEMBER(&Point::y))
+      .Define(env);
+});
+
+LazyExport add_function("add", [](Napi::Env env) -> Napi::Value {
+  ++g_num_definitions;
+  return NewRawFunction(env, "add", NODE_BINDING_MEMBER(&CAdd));
+});
+
+// Gets the class without going through exports.
+Napi::Value NewPoint(const Napi::CallbackInfo& info) {
+  return point_class.Get(info.Env()).As<Napi::Function>().New({});
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  point_class.Export(exports);
+  add_function.Export(exports);
+  exports.Set("numDefinitions",
+              NewRawFunction(env, "numDefinitions",
+                             NODE_BINDING_MEMBER(&NumDefinitions)));
+  exports.Set("newPoint", Napi::Function::New(env, NewPoint));
+  return exports;
+}
+
+NODE_API_MODULE(10_lazy_export, Init)
\ No newline at end of file
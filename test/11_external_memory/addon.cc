@@ -0,0 +1,79 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "blob.h"
+
+#include "node_binding/class.h"
+#include "node_binding/constructor.h"
+#include "node_binding/external_memory.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+using node_binding::ExternalMemory;
+using node_binding::ExternalMemorySize;
+using node_binding::ExternalMemorySizeOf;
+
+namespace node_binding {
+
+template <>
+class ExternalMemorySize<Blob> {
+ public:
+  static size_t Get(const Blob& value) {
+    return ExternalMemorySizeOf(value.data);
+  }
+};
+
+}  // namespace node_binding
+
+class BlobJs : public Napi::ObjectWrap<BlobJs> {
+ public:
+  static void Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("HandWrittenBlob",
+                DefineClass(env, "HandWrittenBlob",
+                            {
+                                InstanceMethod("resize", &BlobJs::Resize),
+                            }));
+  }
+
+  BlobJs(const Napi::CallbackInfo& info) : Napi::ObjectWrap<BlobJs>(info) {
+    blob_ = node_binding::TypedConstruct(
+        info, &node_binding::Constructor<Blob>::Call<int>);
+    external_memory_.Update(info.Env(), ExternalMemorySizeOf(blob_));
+  }
+
+  void Resize(const Napi::CallbackInfo& info) {
+    node_binding::TypedCall(info, &Blob::Resize, &blob_);
+    external_memory_.Update(info.Env(), ExternalMemorySizeOf(blob_));
+  }
+
+ private:
+  Blob blob_;
+  ExternalMemory external_memory_;
+};
+
+// Returns the external memory reported to the JS engine.
+Napi::Value ExternalMemoryOfEnv(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(
+      info.Env(), Napi::MemoryManagement::AdjustExternalMemory(info.Env(), 0));
+}
+
+Napi::Value NewBuffer(const Napi::CallbackInfo& info) {
+  int size = info[0].As<Napi::Number>().Int32Value();
+  return node_binding::NewExternalArrayBuffer(info.Env(),
+                                              std::vector<uint8_t>(size, 1));
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Blob", Class<Blob>("Blob")
+                          .Constructor<int>()
+                          .Method("size", NODE_BINDING_MEMBER(&Blob::size))
+                          .Method("resize", NODE_BINDING_MEMBER(&Blob::Resize))
+                          .Define(env));
+  BlobJs::Init(env, exports);
+  exports.Set("externalMemory", Napi::Function::New(env, ExternalMemoryOfEnv));
+  exports.Set("newBuffer", Napi::Function::New(env, NewBuffer));
+  return exports;
+}
+
+NODE_API_MODULE(11_external_memory, Init)
\ No newline at end of file
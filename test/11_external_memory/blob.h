@@ -0,0 +1,20 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+struct Blob {
+  std::vector<uint8_t> data;
+
+  Blob() = default;
+  explicit Blob(int size) : data(size) {}
+
+  int size() const { return static_cast<int>(data.size()); }
+
+  void Resize(int size) { data = std::vector<uint8_t>(size); }
+};
\ No newline at end of file
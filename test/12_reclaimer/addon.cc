@@ -0,0 +1,93 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "tree.h"
+
+#include "node_binding/class.h"
+#include "node_binding/constructor.h"
+#include "node_binding/reclaimer.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+using node_binding::DeferredDeleter;
+using node_binding::Reclaimer;
+
+namespace node_binding {
+
+template <>
+struct DestructionPolicy<Tree> {
+  static constexpr Destruction value = Destruction::kDeferred;
+};
+
+}  // namespace node_binding
+
+class TreeJs : public Napi::ObjectWrap<TreeJs> {
+ public:
+  static void Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("HandWrittenTree",
+                DefineClass(env, "HandWrittenTree",
+                            {
+                                InstanceMethod("size", &TreeJs::Size),
+                            }));
+  }
+
+  TreeJs(const Napi::CallbackInfo& info) : Napi::ObjectWrap<TreeJs>(info) {
+    tree_.reset(node_binding::TypedConstruct(
+        info, &node_binding::Constructor<Tree>::CallNew<int>));
+  }
+
+  Napi::Value Size(const Napi::CallbackInfo& info) {
+    return node_binding::TypedCall(info, &Tree::size, tree_.get());
+  }
+
+ private:
+  std::unique_ptr<Tree, DeferredDeleter<Tree>> tree_;
+};
+
+Napi::Value Stats(const Napi::CallbackInfo& info) {
+  Reclaimer::Stats stats = Reclaimer::GetInstance().stats();
+  Napi::Object ret = Napi::Object::New(info.Env());
+  ret["pending"] = Napi::Number::New(info.Env(), stats.pending);
+  ret["maxPending"] = Napi::Number::New(info.Env(), stats.max_pending);
+  ret["enqueued"] = Napi::Number::New(info.Env(), stats.enqueued);
+  ret["reclaimed"] = Napi::Number::New(info.Env(), stats.reclaimed);
+  ret["overflowed"] = Napi::Number::New(info.Env(), stats.overflowed);
+  ret["onJSThread"] =
+      Napi::Number::New(info.Env(), DestructionCounter::on_js_thread);
+  ret["offJSThread"] =
+      Napi::Number::New(info.Env(), DestructionCounter::off_js_thread);
+  return ret;
+}
+
+void Flush(const Napi::CallbackInfo& info) {
+  Reclaimer::GetInstance().Flush();
+}
+
+void SetCapacity(const Napi::CallbackInfo& info) {
+  Reclaimer::GetInstance().set_capacity(
+      info[0].As<Napi::Number>().Uint32Value());
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  DestructionCounter::js_thread_id = std::this_thread::get_id();
+
+  exports.Set("Tree", Class<Tree>("Tree")
+                          .Constructor<int>()
+                          .Method("size", NODE_BINDING_MEMBER(&Tree::size))
+                          .Define(env));
+  exports.Set("JSThreadTree",
+              Class<JSThreadTree>("JSThreadTree")
+                  .Constructor<int>()
+                  .Method("size", NODE_BINDING_MEMBER(&JSThreadTree::size))
+                  .Define(env));
+  TreeJs::Init(env, exports);
+  exports.Set("stats", Napi::Function::New(env, Stats));
+  exports.Set("flush", Napi::Function::New(env, Flush));
+  exports.Set("setCapacity", Napi::Function::New(env, SetCapacity));
+  return exports;
+}
+
+NODE_API_MODULE(12_reclaimer, Init)
\ No newline at end of file
@@ -0,0 +1,43 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Counts where trees are destroyed.
+struct DestructionCounter {
+  static std::thread::id js_thread_id;
+  static std::atomic<int> on_js_thread;
+  static std::atomic<int> off_js_thread;
+
+  static void Count() {
+    if (std::this_thread::get_id() == js_thread_id) {
+      ++on_js_thread;
+    } else {
+      ++off_js_thread;
+    }
+  }
+};
+
+std::thread::id DestructionCounter::js_thread_id;
+std::atomic<int> DestructionCounter::on_js_thread(0);
+std::atomic<int> DestructionCounter::off_js_thread(0);
+
+struct Tree {
+  std::vector<int> nodes;
+
+  Tree() = default;
+  explicit Tree(int size) : nodes(size) {}
+  ~Tree() { DestructionCounter::Count(); }
+
+  int size() const { return static_cast<int>(nodes.size()); }
+};
+
+// Same as Tree, but is destroyed on the JS thread.
+struct JSThreadTree : public Tree {
+  using Tree::Tree;
+};
\ No newline at end of file
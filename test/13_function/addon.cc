@@ -0,0 +1,68 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "node_binding/function.h"
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::FunctionRef;
+
+std::vector<int> Sort(std::vector<int> values,
+                      FunctionRef<bool(int, int)> less) {
+  std::sort(values.begin(), values.end(), less);
+  return values;
+}
+
+void ForEach(const std::vector<std::string>& values,
+             FunctionRef<void(const std::string&, int)> visit) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    visit(values[i], static_cast<int>(i));
+  }
+}
+
+std::function<int(int)> g_callback;
+
+void SetCallback(std::function<int(int)> callback) {
+  g_callback = std::move(callback);
+}
+
+int RunCallback(int value) { return g_callback(value); }
+
+void ClearCallback() { g_callback = nullptr; }
+
+Napi::Value SortJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Sort);
+}
+
+void ForEachJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &ForEach);
+}
+
+void SetCallbackJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &SetCallback);
+}
+
+Napi::Value RunCallbackJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &RunCallback);
+}
+
+void ClearCallbackJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &ClearCallback);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("sort", Napi::Function::New(env, SortJs));
+  exports.Set("forEach", Napi::Function::New(env, ForEachJs));
+  exports.Set("setCallback", Napi::Function::New(env, SetCallbackJs));
+  exports.Set("runCallback", Napi::Function::New(env, RunCallbackJs));
+  exports.Set("clearCallback", Napi::Function::New(env, ClearCallbackJs));
+  return exports;
+}
+
+NODE_API_MODULE(13_function, Init)
\ No newline at end of file
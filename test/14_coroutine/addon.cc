@@ -0,0 +1,97 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "node_binding/coroutine.h"
+#include "node_binding/function.h"
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::PromiseRef;
+using node_binding::Task;
+
+// Counts coroutines alive, to check that rejected ones are destroyed.
+int g_alive = 0;
+
+struct Alive {
+  Alive() { ++g_alive; }
+  ~Alive() { --g_alive; }
+};
+
+Task<int> Add(PromiseRef<int> a, PromiseRef<int> b) {
+  Alive alive;
+  int x = co_await a;
+  int y = co_await b;
+  co_return x + y;
+}
+
+uint32_t FibSlow(uint32_t n) {
+  return n < 2 ? n : FibSlow(n - 1) + FibSlow(n - 2);
+}
+
+Task<uint32_t> Fib(uint32_t n) {
+  co_return co_await node_binding::RunInBackground(
+      [n]() { return FibSlow(n); });
+}
+
+// Alternates background work and JS callbacks.
+Task<std::vector<int>> Pipeline(std::vector<int> values,
+                                std::function<int(int)> step) {
+  Alive alive;
+  std::vector<int> results;
+  for (int value : values) {
+    int squared = co_await node_binding::RunInBackground(
+        [value]() { return value * value; });
+    results.push_back(step(squared));
+  }
+  co_return results;
+}
+
+Task<void> Check(Napi::Env env, int value) {
+  Alive alive;
+  co_await node_binding::RunInBackground([]() {});
+  if (value < 0) {
+    co_await node_binding::Reject(
+        Napi::RangeError::New(env, "Negative").Value());
+  }
+}
+
+int CountAlive() { return g_alive; }
+
+Napi::Value AddJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Add);
+}
+
+Napi::Value FibJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Fib);
+}
+
+Napi::Value PipelineJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Pipeline);
+}
+
+Napi::Value CheckJs(const Napi::CallbackInfo& info) {
+  return node_binding::ToJSValue(
+      info, Check(info.Env(), info[0].As<Napi::Number>().Int32Value()));
+}
+
+Napi::Value CountAliveJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CountAlive);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("add", Napi::Function::New(env, AddJs));
+  exports.Set("fib", Napi::Function::New(env, FibJs));
+  exports.Set("pipeline", Napi::Function::New(env, PipelineJs));
+  exports.Set("check", Napi::Function::New(env, CheckJs));
+  exports.Set("countAlive", Napi::Function::New(env, CountAliveJs));
+  return exports;
+}
+
+NODE_API_MODULE(14_coroutine, Init)
@@ -0,0 +1,19 @@
+{
+  "targets": [
+    {
+      "target_name": "14_coroutine",
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "cflags_cc": ["-std=c++20"],
+      "xcode_settings": {"CLANG_CXX_LANGUAGE_STANDARD": "c++20"},
+      "msvs_settings": {
+        "VCCLCompilerTool": {"AdditionalOptions": ["/std:c++20"]},
+      },
+      "sources": ["addon.cc"],
+      "include_dirs": [
+        "<!@(node -p \"require('../../').include\")",
+      ],
+      'defines': ['NAPI_DISABLE_CPP_EXCEPTIONS'],
+    }
+  ]
+}
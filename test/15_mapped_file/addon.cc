@@ -0,0 +1,94 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "node_binding/mapped_file.h"
+#include "node_binding/span.h"
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::MappedArray;
+using node_binding::MappedFile;
+using node_binding::Span;
+
+MappedFile Open(const std::string& path, bool writable) {
+  return MappedFile::Open(path, writable ? MappedFile::Access::kReadWrite
+                                         : MappedFile::Access::kReadOnly);
+}
+
+// Returns two ArrayBuffers of the same read-only mapping.
+std::vector<MappedFile> OpenTwice(const std::string& path) {
+  MappedFile file = MappedFile::Open(path);
+  return {file, file};
+}
+
+MappedFile Slice(const std::string& path, uint32_t offset, uint32_t length) {
+  return MappedFile::Open(path).Slice(offset, length);
+}
+
+MappedArray<float> OpenFloats(const std::string& path, uint32_t offset) {
+  MappedFile file = MappedFile::Open(path);
+  return MappedArray<float>(file.Slice(offset, file.size()));
+}
+
+uint32_t Checksum(Span<const uint8_t> bytes) {
+  uint32_t sum = 0;
+  for (uint8_t byte : bytes) sum += byte;
+  return sum;
+}
+
+double Sum(Span<const float> values) {
+  double sum = 0;
+  for (float value : values) sum += value;
+  return sum;
+}
+
+void Fill(Span<uint8_t> bytes, uint8_t value) {
+  for (uint8_t& byte : bytes) byte = value;
+}
+
+Napi::Value OpenJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Open);
+}
+
+Napi::Value OpenTwiceJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &OpenTwice);
+}
+
+Napi::Value SliceJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Slice);
+}
+
+Napi::Value OpenFloatsJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &OpenFloats);
+}
+
+Napi::Value ChecksumJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Checksum);
+}
+
+Napi::Value SumJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Sum);
+}
+
+void FillJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &Fill);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("open", Napi::Function::New(env, OpenJs));
+  exports.Set("openTwice", Napi::Function::New(env, OpenTwiceJs));
+  exports.Set("slice", Napi::Function::New(env, SliceJs));
+  exports.Set("openFloats", Napi::Function::New(env, OpenFloatsJs));
+  exports.Set("checksum", Napi::Function::New(env, ChecksumJs));
+  exports.Set("sum", Napi::Function::New(env, SumJs));
+  exports.Set("fill", Napi::Function::New(env, FillJs));
+  return exports;
+}
+
+NODE_API_MODULE(15_mapped_file, Init)
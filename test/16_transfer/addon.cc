@@ -0,0 +1,54 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "matrix.h"
+
+#include "node_binding/class.h"
+#include "node_binding/transfer.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+using node_binding::Transfer;
+
+namespace node_binding {
+
+template <>
+struct TransferPolicy<Matrix> {
+  static constexpr Transfer value = Transfer::kShare;
+};
+
+template <>
+struct TransferPolicy<MovableMatrix> {
+  static constexpr Transfer value = Transfer::kMove;
+};
+
+}  // namespace node_binding
+
+Napi::Value Counts(const Napi::CallbackInfo& info) {
+  Napi::Object ret = Napi::Object::New(info.Env());
+  ret["copies"] = Napi::Number::New(info.Env(), MatrixCounter::copies);
+  ret["alive"] = Napi::Number::New(info.Env(), MatrixCounter::alive);
+  ret["pending"] = Napi::Number::New(
+      info.Env(), node_binding::TransferRegistry::GetInstance().size());
+  return ret;
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Matrix", Class<Matrix>("Matrix")
+                            .Constructor<int, int>()
+                            .Method("rows", NODE_BINDING_MEMBER(&Matrix::rows))
+                            .Method("sum", NODE_BINDING_MEMBER(&Matrix::Sum))
+                            .Method("scale",
+                                    NODE_BINDING_MEMBER(&Matrix::Scale))
+                            .Define(env));
+  exports.Set("MovableMatrix",
+              Class<MovableMatrix>("MovableMatrix")
+                  .Constructor<int, int>()
+                  .Method("sum", NODE_BINDING_MEMBER(&MovableMatrix::Sum))
+                  .Define(env));
+  exports.Set("counts", Napi::Function::New(env, Counts));
+  return exports;
+}
+
+NODE_API_MODULE(16_transfer, Init)
@@ -0,0 +1,54 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <vector>
+
+// Counts copies and live objects, to check that transfers don't copy.
+struct MatrixCounter {
+  static std::atomic<int> copies;
+  static std::atomic<int> alive;
+};
+
+std::atomic<int> MatrixCounter::copies(0);
+std::atomic<int> MatrixCounter::alive(0);
+
+class Matrix {
+ public:
+  Matrix(int rows, int cols) : rows_(rows), data_(rows * cols) {
+    for (size_t i = 0; i < data_.size(); ++i) data_[i] = i;
+    ++MatrixCounter::alive;
+  }
+  Matrix(const Matrix& other) : rows_(other.rows_), data_(other.data_) {
+    ++MatrixCounter::copies;
+    ++MatrixCounter::alive;
+  }
+  ~Matrix() { --MatrixCounter::alive; }
+
+  int rows() const { return rows_; }
+
+  double Sum() const {
+    double sum = 0;
+    for (double value : data_) sum += value;
+    return sum;
+  }
+
+  void Scale(double factor) {
+    for (double& value : data_) value *= factor;
+  }
+
+ private:
+  int rows_;
+  std::vector<double> data_;
+};
+
+// Same as Matrix, but can only be moved between envs.
+class MovableMatrix : public Matrix {
+ public:
+  using Matrix::Matrix;
+};
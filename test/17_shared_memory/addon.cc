@@ -0,0 +1,106 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+#include "node_binding/shared_memory.h"
+#include "node_binding/span.h"
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::SharedCounters;
+using node_binding::SharedRingBuffer;
+using node_binding::Span;
+
+using Queue = SharedRingBuffer<int32_t>;
+
+bool Push(Queue queue, int32_t value) { return queue.TryPush(value); }
+
+std::vector<int32_t> Drain(Queue queue) {
+  std::vector<int32_t> values;
+  int32_t value;
+  while (queue.TryPop(&value)) values.push_back(value);
+  return values;
+}
+
+int32_t Count(SharedCounters counters, uint32_t i, int32_t delta) {
+  return counters.Add(i, delta);
+}
+
+uint32_t Checksum(Span<const uint8_t> bytes) {
+  uint32_t sum = 0;
+  for (uint8_t byte : bytes) sum += byte;
+  return sum;
+}
+
+std::vector<std::thread> g_producers;
+
+// Pushes |count| values from |from| on a native thread, counting each push
+// at counters[1]. The caller keeps |queue| and |counters| alive until
+// JoinProducers() returns.
+void ProduceInBackground(Queue queue, SharedCounters counters, int32_t from,
+                         int32_t count) {
+  g_producers.emplace_back([queue, counters, from, count]() mutable {
+    for (int32_t i = from; i < from + count; ++i) {
+      while (!queue.TryPush(i)) std::this_thread::yield();
+      counters.Add(1, 1);
+    }
+  });
+}
+
+void JoinProducers() {
+  for (std::thread& producer : g_producers) producer.join();
+  g_producers.clear();
+}
+
+Napi::Value NewQueue(const Napi::CallbackInfo& info) {
+  return Queue::New(info.Env(), info[0].As<Napi::Number>().Uint32Value());
+}
+
+Napi::Value NewCounters(const Napi::CallbackInfo& info) {
+  return SharedCounters::New(info.Env(),
+                             info[0].As<Napi::Number>().Uint32Value());
+}
+
+Napi::Value PushJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Push);
+}
+
+Napi::Value DrainJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Drain);
+}
+
+Napi::Value CountJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Count);
+}
+
+Napi::Value ChecksumJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Checksum);
+}
+
+void ProduceInBackgroundJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &ProduceInBackground);
+}
+
+void JoinProducersJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &JoinProducers);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("newQueue", Napi::Function::New(env, NewQueue));
+  exports.Set("newCounters", Napi::Function::New(env, NewCounters));
+  exports.Set("push", Napi::Function::New(env, PushJs));
+  exports.Set("drain", Napi::Function::New(env, DrainJs));
+  exports.Set("count", Napi::Function::New(env, CountJs));
+  exports.Set("checksum", Napi::Function::New(env, ChecksumJs));
+  exports.Set("produceInBackground",
+              Napi::Function::New(env, ProduceInBackgroundJs));
+  exports.Set("joinProducers", Napi::Function::New(env, JoinProducersJs));
+  return exports;
+}
+
+NODE_API_MODULE(17_shared_memory, Init)
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "node_binding/class.h"
+#include "node_binding/raw_call.h"
+#include "node_binding/stl.h"
+#include "node_binding/trace.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+using node_binding::NewRawFunction;
+using node_binding::Tracer;
+
+class Counter {
+ public:
+  explicit Counter(int count) : count_(count) {}
+
+  int Add(int delta) { return count_ += delta; }
+
+ private:
+  int count_;
+};
+
+std::vector<int> Range(int n) {
+  std::vector<int> ret;
+  for (int i = 0; i < n; ++i) ret.push_back(i);
+  return ret;
+}
+
+double Multiply(double a, double b) { return a * b; }
+
+// Records on native threads, which exit before the trace is flushed.
+void TraceInThreads(int num_threads) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([]() { NODE_BINDING_TRACE_SCOPE("Work"); });
+  }
+  for (std::thread& thread : threads) thread.join();
+}
+
+void StartTracing(int buffer_size) {
+  Tracer::GetInstance().set_buffer_size(buffer_size);
+  Tracer::GetInstance().Start();
+}
+
+void StopTracing() { Tracer::GetInstance().Stop(); }
+
+bool FlushTrace(const std::string& path) {
+  return Tracer::GetInstance().Flush(path);
+}
+
+Napi::Value RangeJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &Range);
+}
+
+void TraceInThreadsJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &TraceInThreads);
+}
+
+void StartTracingJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &StartTracing);
+}
+
+void StopTracingJs(const Napi::CallbackInfo& info) {
+  node_binding::TypedCall(info, &StopTracing);
+}
+
+Napi::Value FlushTraceJs(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &FlushTrace);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Counter", Class<Counter>("Counter")
+                             .Constructor<int>()
+                             .Method("add", NODE_BINDING_MEMBER(&Counter::Add))
+                             .Define(env));
+  exports.Set("range", Napi::Function::New(env, RangeJs));
+  exports.Set("multiply", NewRawFunction(env, "multiply",
+                                         NODE_BINDING_MEMBER(&Multiply)));
+  exports.Set("traceInThreads", Napi::Function::New(env, TraceInThreadsJs));
+  exports.Set("startTracing", Napi::Function::New(env, StartTracingJs));
+  exports.Set("stopTracing", Napi::Function::New(env, StopTracingJs));
+  exports.Set("flushTrace", Napi::Function::New(env, FlushTraceJs));
+  return exports;
+}
+
+NODE_API_MODULE(18_trace, Init)
@@ -0,0 +1,111 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "node_binding/class.h"
+#include "node_binding/iterable.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+using node_binding::Iterable;
+
+// Counts the elements read through it.
+class CountingIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const int*;
+  using reference = int;
+
+  static int reads;
+
+  explicit CountingIterator(int value) : value_(value) {}
+
+  int operator*() const {
+    ++reads;
+    return value_;
+  }
+  CountingIterator& operator++() {
+    ++value_;
+    return *this;
+  }
+  bool operator==(const CountingIterator& other) const {
+    return value_ == other.value_;
+  }
+  bool operator!=(const CountingIterator& other) const {
+    return value_ != other.value_;
+  }
+
+ private:
+  int value_;
+};
+
+int CountingIterator::reads = 0;
+
+class Playlist {
+ public:
+  static int alive;
+
+  Playlist() { ++alive; }
+  Playlist(const Playlist& other) : songs_(other.songs_) { ++alive; }
+  ~Playlist() { --alive; }
+
+  void Add(const std::string& song) { songs_.push_back(song); }
+
+  // Iterates songs in place, which keeps this alive.
+  Iterable<std::vector<std::string>::const_iterator> Songs() const {
+    return node_binding::MakeIterable(songs_);
+  }
+
+ private:
+  std::vector<std::string> songs_;
+};
+
+int Playlist::alive = 0;
+
+Iterable<CountingIterator> CCount(int n) {
+  return {CountingIterator(0), CountingIterator(n)};
+}
+
+Iterable<std::vector<int>::const_iterator> CSquares(int n) {
+  std::vector<int> squares;
+  for (int i = 0; i < n; ++i) squares.push_back(i * i);
+  return node_binding::MakeOwnedIterable(std::move(squares));
+}
+
+Napi::Value Count(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CCount);
+}
+
+Napi::Value Squares(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CSquares);
+}
+
+Napi::Value Reads(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), CountingIterator::reads);
+}
+
+Napi::Value AlivePlaylists(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), Playlist::alive);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Playlist",
+              Class<Playlist>("Playlist")
+                  .Constructor<>()
+                  .Method("add", NODE_BINDING_MEMBER(&Playlist::Add))
+                  .Method("songs", NODE_BINDING_MEMBER(&Playlist::Songs))
+                  .Define(env));
+  exports.Set("count", Napi::Function::New(env, Count));
+  exports.Set("squares", Napi::Function::New(env, Squares));
+  exports.Set("reads", Napi::Function::New(env, Reads));
+  exports.Set("alivePlaylists", Napi::Function::New(env, AlivePlaylists));
+  return exports;
+}
+
+NODE_API_MODULE(19_iterable, Init)
@@ -0,0 +1,138 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+#include "node_binding/variant.h"
+
+struct Point {
+  int x = 0;
+  int y = 0;
+};
+
+// Counts how often a JS value is checked for a Point.
+int point_checks = 0;
+
+namespace node_binding {
+
+template <>
+class TypeConvertor<Point> {
+ public:
+  static Point ToNativeValue(const Napi::Value& value) {
+    Napi::Object object = value.As<Napi::Object>();
+    return {object.Get("x").As<Napi::Number>().Int32Value(),
+            object.Get("y").As<Napi::Number>().Int32Value()};
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    ++point_checks;
+    if (!value.IsObject() || value.IsArray()) return false;
+    Napi::Object object = value.As<Napi::Object>();
+    return object.Get("x").IsNumber() && object.Get("y").IsNumber();
+  }
+
+  static Napi::Value ToJSValue(Napi::Env env, const Point& value) {
+    Napi::Object object = Napi::Object::New(env);
+    object.Set("x", value.x);
+    object.Set("y", value.y);
+    return object;
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Point& value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+template <>
+struct JSTypeOf<Point> : JSTypes<napi_object> {};
+
+}  // namespace node_binding
+
+using Shape = std::variant<int, std::string, std::vector<int>, Point>;
+
+std::string CDescribe(const Shape& shape) {
+  if (const int* n = std::get_if<int>(&shape)) {
+    return "int " + std::to_string(*n);
+  }
+  if (const std::string* s = std::get_if<std::string>(&shape)) {
+    return "string " + *s;
+  }
+  if (const std::vector<int>* v = std::get_if<std::vector<int>>(&shape)) {
+    return "vector of " + std::to_string(v->size());
+  }
+  const Point& p = std::get<Point>(shape);
+  return "point " + std::to_string(p.x) + "," + std::to_string(p.y);
+}
+
+Shape CMirror(const Shape& shape) {
+  if (const Point* p = std::get_if<Point>(&shape)) return Point{p->y, p->x};
+  return shape;
+}
+
+std::variant<std::monostate, double, std::string> CParse(
+    const std::string& text) {
+  if (text.empty()) return std::monostate();
+  char* end;
+  double number = strtod(text.c_str(), &end);
+  if (*end == '\0') return number;
+  return text;
+}
+
+std::string CGreet(std::optional<std::string> name) {
+  return "hello " + name.value_or("world");
+}
+
+std::optional<int> CFind(const std::vector<int>& values, int value) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i] == value) return static_cast<int>(i);
+  }
+  return std::nullopt;
+}
+
+Napi::Value Describe(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CDescribe);
+}
+
+Napi::Value DescribeTrusted(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall<node_binding::TrustedArgs>(info, &CDescribe);
+}
+
+Napi::Value Mirror(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CMirror);
+}
+
+Napi::Value Parse(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CParse);
+}
+
+Napi::Value Greet(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CGreet);
+}
+
+Napi::Value Find(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CFind);
+}
+
+Napi::Value PointChecks(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), point_checks);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("describe", Napi::Function::New(env, Describe));
+  exports.Set("describeTrusted", Napi::Function::New(env, DescribeTrusted));
+  exports.Set("mirror", Napi::Function::New(env, Mirror));
+  exports.Set("parse", Napi::Function::New(env, Parse));
+  exports.Set("greet", Napi::Function::New(env, Greet));
+  exports.Set("find", Napi::Function::New(env, Find));
+  exports.Set("pointChecks", Napi::Function::New(env, PointChecks));
+  return exports;
+}
+
+NODE_API_MODULE(20_variant, Init)
@@ -0,0 +1,77 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "node_binding/class.h"
+#include "node_binding/function.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+
+class Text {
+ public:
+  explicit Text(std::u16string_view text) : text_(text) {}
+
+  size_t Size() const { return text_.size(); }
+
+  std::u16string_view View() const { return text_; }
+
+ private:
+  std::u16string text_;
+};
+
+std::u16string CReverse(const std::u16string& text) {
+  return std::u16string(text.rbegin(), text.rend());
+}
+
+size_t CLength(std::u16string_view text) { return text.size(); }
+
+std::u16string CConcat(std::u16string_view a, std::u16string_view b) {
+  std::u16string ret(a);
+  ret += b;
+  return ret;
+}
+
+// Calls back into JS while |text| is in use, which may decode other strings.
+std::u16string CAround(
+    std::u16string_view text,
+    const std::function<std::u16string(std::u16string_view)>& f) {
+  std::u16string ret = f(text);
+  ret += text;
+  return ret;
+}
+
+Napi::Value Reverse(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CReverse);
+}
+
+Napi::Value Length(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CLength);
+}
+
+Napi::Value Concat(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CConcat);
+}
+
+Napi::Value Around(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CAround);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Text", Class<Text>("Text")
+                          .Constructor<std::u16string_view>()
+                          .Method("size", NODE_BINDING_MEMBER(&Text::Size))
+                          .Method("view", NODE_BINDING_MEMBER(&Text::View))
+                          .Define(env));
+  exports.Set("reverse", Napi::Function::New(env, Reverse));
+  exports.Set("length", Napi::Function::New(env, Length));
+  exports.Set("concat", Napi::Function::New(env, Concat));
+  exports.Set("around", Napi::Function::New(env, Around));
+  return exports;
+}
+
+NODE_API_MODULE(21_utf16, Init)
@@ -0,0 +1,119 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "node_binding/packed.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::MakePackedField;
+using node_binding::Packed;
+
+struct Point {
+  int32_t x = 0;
+  int32_t y = 0;
+};
+
+struct Layer {
+  std::string label;
+  bool visible = true;
+  double opacity = 1;
+  std::vector<Point> points;
+  std::vector<uint8_t> mask;
+};
+
+struct Scene {
+  std::string name;
+  int64_t version = 0;
+  std::vector<Layer> layers;
+  std::vector<std::string> tags;
+};
+
+namespace node_binding {
+
+template <>
+struct PackedSchema<Point> {
+  static auto Fields() {
+    return std::make_tuple(MakePackedField("x", &Point::x),
+                           MakePackedField("y", &Point::y));
+  }
+};
+
+template <>
+struct PackedSchema<Layer> {
+  static auto Fields() {
+    return std::make_tuple(MakePackedField("label", &Layer::label),
+                           MakePackedField("visible", &Layer::visible),
+                           MakePackedField("opacity", &Layer::opacity),
+                           MakePackedField("points", &Layer::points),
+                           MakePackedField("mask", &Layer::mask));
+  }
+};
+
+template <>
+struct PackedSchema<Scene> {
+  static auto Fields() {
+    return std::make_tuple(MakePackedField("name", &Scene::name),
+                           MakePackedField("version", &Scene::version),
+                           MakePackedField("layers", &Scene::layers),
+                           MakePackedField("tags", &Scene::tags));
+  }
+};
+
+}  // namespace node_binding
+
+Packed<Scene> CMakeScene(int num_layers, int num_points) {
+  Scene scene;
+  scene.name = "scene";
+  scene.version = 1;
+  for (int i = 0; i < num_layers; ++i) {
+    Layer layer;
+    layer.label = "layer " + std::to_string(i);
+    layer.visible = i % 2 == 0;
+    layer.opacity = 0.5;
+    for (int j = 0; j < num_points; ++j) layer.points.push_back({i, j});
+    layer.mask = {1, 2, 3};
+    scene.layers.push_back(std::move(layer));
+  }
+  scene.tags = {"a", "\xc3\xa9"};
+  return scene;
+}
+
+// Sums coordinates of visible layers.
+int64_t CSumVisible(const Packed<Scene>& scene) {
+  int64_t sum = 0;
+  for (const Layer& layer : scene->layers) {
+    if (!layer.visible) continue;
+    for (const Point& point : layer.points) sum += point.x + point.y;
+  }
+  return sum;
+}
+
+Packed<Scene> CEcho(const Packed<Scene>& scene) { return scene; }
+
+Napi::Value MakeScene(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CMakeScene);
+}
+
+Napi::Value SumVisible(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CSumVisible);
+}
+
+Napi::Value Echo(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CEcho);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("makeScene", Napi::Function::New(env, MakeScene));
+  exports.Set("sumVisible", Napi::Function::New(env, SumVisible));
+  exports.Set("echo", Napi::Function::New(env, Echo));
+  exports.Set("sceneCodec", node_binding::PackedCodec<Scene>(env));
+  return exports;
+}
+
+NODE_API_MODULE(22_packed, Init)
@@ -0,0 +1,82 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "node_binding/span.h"
+#include "node_binding/stl.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::CoercingArgs;
+using node_binding::Span;
+using node_binding::StrictArgs;
+using node_binding::TrustedArgs;
+
+int CAdd(int a, int b) { return a + b; }
+
+int CSum(const std::vector<int>& values) {
+  int sum = 0;
+  for (int value : values) sum += value;
+  return sum;
+}
+
+int CLength(Span<const float> values) {
+  return static_cast<int>(values.size());
+}
+
+int CByteLength(Span<const uint8_t> bytes) {
+  return static_cast<int>(bytes.size());
+}
+
+std::string CJoin(const std::string& a, bool b) {
+  return a + (b ? " yes" : " no");
+}
+
+template <typename Policy>
+Napi::Value Add(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall<Policy>(info, &CAdd);
+}
+
+template <typename Policy>
+Napi::Value Sum(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall<Policy>(info, &CSum);
+}
+
+template <typename Policy>
+Napi::Value Length(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall<Policy>(info, &CLength);
+}
+
+template <typename Policy>
+Napi::Value ByteLength(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall<Policy>(info, &CByteLength);
+}
+
+template <typename Policy>
+Napi::Value Join(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall<Policy>(info, &CJoin);
+}
+
+template <typename Policy>
+Napi::Object Bindings(Napi::Env env) {
+  Napi::Object bindings = Napi::Object::New(env);
+  bindings.Set("add", Napi::Function::New(env, Add<Policy>));
+  bindings.Set("sum", Napi::Function::New(env, Sum<Policy>));
+  bindings.Set("length", Napi::Function::New(env, Length<Policy>));
+  bindings.Set("byteLength", Napi::Function::New(env, ByteLength<Policy>));
+  bindings.Set("join", Napi::Function::New(env, Join<Policy>));
+  return bindings;
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("strict", Bindings<StrictArgs>(env));
+  exports.Set("coercing", Bindings<CoercingArgs>(env));
+  exports.Set("trusted", Bindings<TrustedArgs>(env));
+  return exports;
+}
+
+NODE_API_MODULE(23_arg_policy, Init)
@@ -0,0 +1,94 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "node_binding/class.h"
+#include "node_binding/constructor.h"
+#include "node_binding/object_pool.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+using node_binding::NativeDeleter;
+using node_binding::ObjectPool;
+
+struct Particle {
+  double x = 0;
+  double y = 0;
+  double vx = 0;
+
+  Particle() {}
+  Particle(double x, double vx) : x(x), vx(vx) {}
+
+  void Step() { x += vx; }
+};
+
+namespace node_binding {
+
+template <>
+struct AllocationPolicy<Particle> {
+  static constexpr Allocation value = Allocation::kPooled;
+};
+
+}  // namespace node_binding
+
+class ParticleJs : public Napi::ObjectWrap<ParticleJs> {
+ public:
+  static void Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("HandWrittenParticle",
+                DefineClass(env, "HandWrittenParticle",
+                            {
+                                InstanceMethod("x", &ParticleJs::X),
+                            }));
+  }
+
+  ParticleJs(const Napi::CallbackInfo& info)
+      : Napi::ObjectWrap<ParticleJs>(info) {
+    particle_.reset(node_binding::TypedConstruct(
+        info, &node_binding::Constructor<Particle>::CallNew<double, double>));
+  }
+
+  Napi::Value X(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), particle_->x);
+  }
+
+ private:
+  std::unique_ptr<Particle, NativeDeleter<Particle>> particle_;
+};
+
+Napi::Value Stats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::vector<ObjectPool::Stats> stats = ObjectPool::GetInstance().stats();
+  Napi::Array ret = Napi::Array::New(env, stats.size());
+  for (size_t i = 0; i < stats.size(); ++i) {
+    Napi::Object stat = Napi::Object::New(env);
+    stat["blockSize"] = Napi::Number::New(env, stats[i].block_size);
+    stat["reserved"] = Napi::Number::New(env, stats[i].reserved);
+    stat["inUse"] = Napi::Number::New(env, stats[i].in_use);
+    stat["cached"] = Napi::Number::New(env, stats[i].cached);
+    stat["shared"] = Napi::Number::New(env, stats[i].shared);
+    stat["allocated"] = Napi::Number::New(env, stats[i].allocated);
+    stat["exchanged"] = Napi::Number::New(env, stats[i].exchanged);
+    ret[i] = stat;
+  }
+  return ret;
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Particle",
+              Class<Particle>("Particle")
+                  .Constructor<double, double>()
+                  .Field("x", NODE_BINDING_MEMBER(&Particle::x))
+                  .Field("y", NODE_BINDING_MEMBER(&Particle::y))
+                  .Method("step", NODE_BINDING_MEMBER(&Particle::Step))
+                  .Define(env));
+  ParticleJs::Init(env, exports);
+  exports.Set("stats", Napi::Function::New(env, Stats));
+  exports.Set("particleBlockSize",
+              Napi::Number::New(env, (sizeof(Particle) + 15) / 16 * 16));
+  return exports;
+}
+
+NODE_API_MODULE(24_object_pool, Init)
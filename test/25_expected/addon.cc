@@ -0,0 +1,83 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdlib.h>
+
+#include <map>
+#include <string>
+
+#include "node_binding/expected.h"
+#include "node_binding/raw_call.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Expected;
+using node_binding::Failure;
+using node_binding::NewRawFunction;
+using node_binding::Result;
+
+constexpr Failure kInvalid("EINVAL", "Not an integer");
+constexpr Failure kNotFound("ENOTFOUND", "Key is not found");
+constexpr Failure kNegative("ERANGE", "Value is negative");
+
+bool ParseInt(const std::string& text, int* value) {
+  char* end;
+  long parsed = strtol(text.c_str(), &end, 10);
+  if (text.empty() || *end != '\0') return false;
+  *value = static_cast<int>(parsed);
+  return true;
+}
+
+Expected<int> CParse(const std::string& text) {
+  int value;
+  if (!ParseInt(text, &value)) return kInvalid;
+  return value;
+}
+
+Result<int> CTryParse(const std::string& text) {
+  int value;
+  if (!ParseInt(text, &value)) return kInvalid;
+  return value;
+}
+
+Result<std::string> CLookup(const std::string& key) {
+  static const std::map<std::string, std::string> table = {
+      {"a", "apple"}, {"b", "banana"}};
+  auto it = table.find(key);
+  if (it == table.end()) return kNotFound;
+  return it->second;
+}
+
+Expected<void> CCheck(int value) {
+  if (value < 0) return kNegative;
+  return {};
+}
+
+Napi::Value Parse(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CParse);
+}
+
+Napi::Value TryParse(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CTryParse);
+}
+
+Napi::Value Lookup(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CLookup);
+}
+
+Napi::Value Check(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CCheck);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("parse", Napi::Function::New(env, Parse));
+  exports.Set("tryParse", Napi::Function::New(env, TryParse));
+  exports.Set("lookup", Napi::Function::New(env, Lookup));
+  exports.Set("check", Napi::Function::New(env, Check));
+  exports.Set("rawTryParse",
+              NewRawFunction(env, "rawTryParse",
+                             NODE_BINDING_MEMBER(&CTryParse)));
+  return exports;
+}
+
+NODE_API_MODULE(25_expected, Init)
@@ -0,0 +1,97 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include "node_binding/class.h"
+#include "node_binding/field_storage.h"
+#include "node_binding/typed_call.h"
+
+using node_binding::Class;
+
+struct Particle {
+  double x = 0;
+  double y = 0;
+  int32_t id = 0;
+  bool alive = true;
+  int64_t stamp = 0;
+
+  Particle() {}
+  Particle(double x, double y) : x(x), y(y) {}
+
+  void Step(double dt) {
+    x += dt;
+    y += dt;
+  }
+
+  double Sum() const { return x + y; }
+};
+
+namespace node_binding {
+
+template <>
+struct StoragePolicy<Particle> {
+  static constexpr Storage value = Storage::kArrayBuffer;
+};
+
+template <>
+class TypeConvertor<Particle> {
+ public:
+  static Particle ToNativeValue(const Napi::Value& value) {
+    return *Class<Particle>::Unwrap(value);
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return Class<Particle>::Unwrap(value) != nullptr;
+  }
+
+  static Napi::Value ToJSValue(Napi::Env env, const Particle& value) {
+    return Class<Particle>::New(env, value);
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Particle& value) {
+    return ToJSValue(info.Env(), value);
+  }
+};
+
+}  // namespace node_binding
+
+Particle CMirror(const Particle& particle) {
+  Particle mirrored = particle;
+  mirrored.x = particle.y;
+  mirrored.y = particle.x;
+  return mirrored;
+}
+
+Napi::Value Mirror(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CMirror);
+}
+
+// Returns an external of memory no class has allocated, like one made by
+// another addon.
+Napi::Value NewExternal(const Napi::CallbackInfo& info) {
+  static double memory[8];
+  return Napi::External<double>::New(info.Env(), memory);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Particle",
+              Class<Particle>("Particle")
+                  .Constructor<>()
+                  .Constructor<double, double>()
+                  .Field("x", NODE_BINDING_MEMBER(&Particle::x))
+                  .Field("y", NODE_BINDING_MEMBER(&Particle::y))
+                  .ReadOnlyField("id", NODE_BINDING_MEMBER(&Particle::id))
+                  .Field("alive", NODE_BINDING_MEMBER(&Particle::alive))
+                  .Field("stamp", NODE_BINDING_MEMBER(&Particle::stamp))
+                  .Method("step", NODE_BINDING_MEMBER(&Particle::Step))
+                  .Method("sum", NODE_BINDING_MEMBER(&Particle::Sum))
+                  .Define(env));
+  exports.Set("mirror", Napi::Function::New(env, Mirror));
+  exports.Set("newExternal", Napi::Function::New(env, NewExternal));
+  return exports;
+}
+
+NODE_API_MODULE(26_array_buffer_fields, Init)
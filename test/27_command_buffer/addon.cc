@@ -0,0 +1,74 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include "node_binding/class.h"
+
+using node_binding::Class;
+
+class Calculator {
+ public:
+  Calculator() {}
+
+  void Increment(int32_t delta) {
+    if (!locked_) result_ += delta;
+  }
+
+  void Decrement() {
+    if (!locked_) --result_;
+  }
+
+  void Scale(double factor) {
+    if (!locked_) result_ *= factor;
+  }
+
+  void SetLocked(bool locked) { locked_ = locked; }
+
+  void Clear() { result_ = 0; }
+
+  double result() const { return result_; }
+
+ private:
+  double result_ = 0;
+  bool locked_ = false;
+};
+
+class Counter {
+ public:
+  void Increment() { ++count_; }
+
+ private:
+  int count_ = 0;
+};
+
+Napi::Value DefineReserved(const Napi::CallbackInfo& info) {
+  return Class<Counter>("Counter")
+      .Command("flush", NODE_BINDING_MEMBER(&Counter::Increment))
+      .Define(info.Env());
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set(
+      "Calculator",
+      Class<Calculator>("Calculator")
+          .Constructor<>()
+          .Method("result", NODE_BINDING_MEMBER(&Calculator::result))
+          .Command("increment", NODE_BINDING_MEMBER(&Calculator::Increment))
+          .Command("decrement", NODE_BINDING_MEMBER(&Calculator::Decrement))
+          .Command("scale", NODE_BINDING_MEMBER(&Calculator::Scale))
+          .Command("setLocked", NODE_BINDING_MEMBER(&Calculator::SetLocked))
+          .Command("clear", NODE_BINDING_MEMBER(&Calculator::Clear))
+          .Define(env));
+  exports.Set("Counter",
+              Class<Counter>("Counter")
+                  .Constructor<>()
+                  .Command("increment",
+                           NODE_BINDING_MEMBER(&Counter::Increment))
+                  .Define(env));
+  exports.Set("defineReserved", Napi::Function::New(env, DefineReserved));
+  return exports;
+}
+
+NODE_API_MODULE(27_command_buffer, Init)
@@ -2,6 +2,12 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "node_binding/stl.h"
 #include "node_binding/typed_call.h"
 
@@ -21,6 +27,49 @@ std::vector<int> CLinSpace(int from, int to, int step) {
   return ret;
 }
 
+std::map<std::string, int> CCountWords(const std::vector<std::string>& words) {
+  std::map<std::string, int> ret;
+  for (const std::string& word : words) {
+    ++ret[word];
+  }
+  return ret;
+}
+
+std::unordered_map<int, std::string> CInvert(
+    const std::unordered_map<std::string, int>& map) {
+  std::unordered_map<int, std::string> ret;
+  for (const auto& entry : map) {
+    ret.emplace(entry.second, entry.first);
+  }
+  return ret;
+}
+
+int CLookup(const std::map<std::string, int>& map, const std::string& key) {
+  auto it = map.find(key);
+  return it == map.end() ? -1 : it->second;
+}
+
+std::map<std::string, int> CSumEach(
+    const std::unordered_map<std::string, std::vector<int>>& map) {
+  std::map<std::string, int> ret;
+  for (const auto& entry : map) {
+    ret[entry.first] = CSum(entry.second);
+  }
+  return ret;
+}
+
+std::set<int> CUnique(const std::vector<int>& vec) {
+  return std::set<int>(vec.begin(), vec.end());
+}
+
+int CSumSet(const std::unordered_set<int>& set) {
+  int ret = 0;
+  for (int v : set) {
+    ret += v;
+  }
+  return ret;
+}
+
 Napi::Value Sum(const Napi::CallbackInfo& info) {
   return node_binding::TypedCall(info, &CSum);
 }
@@ -29,9 +78,39 @@ Napi::Value LinSpace(const Napi::CallbackInfo& info) {
   return node_binding::TypedCall(info, &CLinSpace);
 }
 
+Napi::Value CountWords(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CCountWords);
+}
+
+Napi::Value Invert(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CInvert);
+}
+
+Napi::Value Lookup(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CLookup);
+}
+
+Napi::Value SumEach(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CSumEach);
+}
+
+Napi::Value Unique(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CUnique);
+}
+
+Napi::Value SumSet(const Napi::CallbackInfo& info) {
+  return node_binding::TypedCall(info, &CSumSet);
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set("sum", Napi::Function::New(env, Sum));
   exports.Set("linSpace", Napi::Function::New(env, LinSpace));
+  exports.Set("countWords", Napi::Function::New(env, CountWords));
+  exports.Set("invert", Napi::Function::New(env, Invert));
+  exports.Set("lookup", Napi::Function::New(env, Lookup));
+  exports.Set("sumEach", Napi::Function::New(env, SumEach));
+  exports.Set("unique", Napi::Function::New(env, Unique));
+  exports.Set("sumSet", Napi::Function::New(env, SumSet));
   return exports;
 }
 
@@ -0,0 +1,125 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "point.h"
+#include "rect.h"
+
+#include "node_binding/constructor.h"
+#include "node_binding/member_view.h"
+#include "node_binding/typed_call.h"
+
+class PointJs : public Napi::ObjectWrap<PointJs> {
+ public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewView(Napi::Object owner, Point* p) {
+    return node_binding::NewMemberView(constructor_, owner, p);
+  }
+  PointJs(const Napi::CallbackInfo& info);
+
+  void SetX(const Napi::CallbackInfo& info, const Napi::Value& v) {
+    point_->x = node_binding::ToNativeValue<int>(v);
+  }
+
+  void SetY(const Napi::CallbackInfo& info, const Napi::Value& v) {
+    point_->y = node_binding::ToNativeValue<int>(v);
+  }
+
+  Napi::Value GetX(const Napi::CallbackInfo& info) {
+    return node_binding::ToJSValue(info, point_->x);
+  }
+
+  Napi::Value GetY(const Napi::CallbackInfo& info) {
+    return node_binding::ToJSValue(info, point_->y);
+  }
+
+ private:
+  static Napi::FunctionReference constructor_;
+
+  node_binding::ViewableValue<Point> point_;
+};
+
+Napi::FunctionReference PointJs::constructor_;
+
+// static
+void PointJs::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func =
+      DefineClass(env, "Point",
+                  {
+                      InstanceAccessor("x", &PointJs::GetX, &PointJs::SetX),
+                      InstanceAccessor("y", &PointJs::GetY, &PointJs::SetY),
+                  });
+
+  constructor_ = Napi::Persistent(func);
+  constructor_.SuppressDestruct();
+
+  exports.Set("Point", func);
+}
+
+PointJs::PointJs(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<PointJs>(info) {
+  if (node_binding::IsMemberViewConstructCall(info)) {
+    point_.BindMemberView(info);
+  } else if (info.Length() == 2) {
+    point_ = node_binding::TypedConstruct(
+        info, &node_binding::Constructor<Point>::Call<int, int>);
+  } else if (info.Length() != 0) {
+    Napi::Env env = info.Env();
+    THROW_JS_WRONG_NUMBER_OF_ARGUMENTS(env);
+  }
+}
+
+class RectJs : public Napi::ObjectWrap<RectJs> {
+ public:
+  static void Init(Napi::Env env, Napi::Object exports);
+  using Napi::ObjectWrap<RectJs>::ObjectWrap;
+
+  Napi::Value GetTopLeft(const Napi::CallbackInfo& info) {
+    return top_left_view_.Get(
+        [this]() { return PointJs::NewView(Value(), &rect_.top_left); });
+  }
+
+  Napi::Value GetBottomRight(const Napi::CallbackInfo& info) {
+    return bottom_right_view_.Get(
+        [this]() { return PointJs::NewView(Value(), &rect_.bottom_right); });
+  }
+
+  Napi::Value Area(const Napi::CallbackInfo& info) {
+    return node_binding::TypedCall(info, &Rect::Area, &rect_);
+  }
+
+ private:
+  Rect rect_;
+  node_binding::MemberViewCache top_left_view_;
+  node_binding::MemberViewCache bottom_right_view_;
+};
+
+// static
+void RectJs::Init(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(
+      env, "Rect",
+      {
+          InstanceAccessor("topLeft", &RectJs::GetTopLeft, nullptr),
+          InstanceAccessor("bottomRight", &RectJs::GetBottomRight, nullptr),
+          InstanceMethod("area", &RectJs::Area),
+      });
+
+  exports.Set("Rect", func);
+}
+
+// Returns an external of memory no view has been made of, like one made by
+// another addon.
+Napi::Value NewExternal(const Napi::CallbackInfo& info) {
+  static Point point;
+  return Napi::External<Point>::New(info.Env(), &point);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  PointJs::Init(env, exports);
+  RectJs::Init(env, exports);
+  exports.Set("newExternal", Napi::Function::New(env, NewExternal));
+
+  return exports;
+}
+
+NODE_API_MODULE(7_member_view, Init)
\ No newline at end of file
@@ -0,0 +1,12 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+struct Point {
+  int x;
+  int y;
+
+  Point(int x = 0, int y = 0) : x(x), y(y) {}
+};
\ No newline at end of file
@@ -0,0 +1,16 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include "point.h"
+
+struct Rect {
+  Point top_left;
+  Point bottom_right;
+
+  int Area() const {
+    return (top_left.y - bottom_right.y) * (bottom_right.x - top_left.x);
+  }
+};
\ No newline at end of file
@@ -0,0 +1,82 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdlib>
+
+#include "calculator.h"
+#include "point.h"
+
+#include "node_binding/class.h"
+
+using node_binding::Class;
+
+namespace node_binding {
+
+template <>
+class TypeConvertor<Point> {
+ public:
+  static Point ToNativeValue(const Napi::Value& value) {
+    return *Class<Point>::Unwrap(value);
+  }
+
+  static bool IsConvertible(const Napi::Value& value) {
+    return Class<Point>::Unwrap(value) != nullptr;
+  }
+
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Point& value) {
+    return Class<Point>::New(info.Env(), value);
+  }
+};
+
+}  // namespace node_binding
+
+struct Line {
+  Point from;
+  Point to;
+
+  Line() {}
+  Line(const Point& from, const Point& to) : from(from), to(to) {}
+
+  int Length() const {
+    return std::abs(to.x - from.x) + std::abs(to.y - from.y);
+  }
+};
+
+// Returns an external of memory no class has allocated, like one made by
+// another addon.
+Napi::Value NewExternal(const Napi::CallbackInfo& info) {
+  static double memory[8];
+  return Napi::External<double>::New(info.Env(), memory);
+}
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("Point", Class<Point>("Point")
+                           .Constructor<>()
+                           .Constructor<int, int>()
+                           .Field("x", NODE_BINDING_MEMBER(&Point::x))
+                           .Field("y", NODE_BINDING_MEMBER(&Point::y))
+                           .Define(env));
+  exports.Set("Line", Class<Line>("Line")
+                          .Constructor<const Point&, const Point&>()
+                          .Field("from", NODE_BINDING_MEMBER(&Line::from))
+                          .ReadOnlyField("to", NODE_BINDING_MEMBER(&Line::to))
+                          .Method("length", NODE_BINDING_MEMBER(&Line::Length))
+                          .Define(env));
+  exports.Set(
+      "Calculator",
+      Class<Calculator>("Calculator")
+          .Constructor<>()
+          .Constructor<int>()
+          .StaticMethod("add", NODE_BINDING_MEMBER(&Calculator::Add))
+          .Method("result", NODE_BINDING_MEMBER(&Calculator::result))
+          .Method("increment", NODE_BINDING_MEMBER(&Calculator::Increment))
+          .Method("clear", NODE_BINDING_MEMBER(&Calculator::Clear))
+          .Define(env));
+  exports.Set("newExternal", Napi::Function::New(env, NewExternal));
+
+  return exports;
+}
+
+NODE_API_MODULE(8_class, Init)
\ No newline at end of file
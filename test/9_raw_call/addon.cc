@@ -0,0 +1,77 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "node_binding/raw_call.h"
+#include "node_binding/stl.h"
+
+using node_binding::NewRawFunction;
+
+struct Pair {
+  int first;
+  int second;
+};
+
+namespace node_binding {
+
+// Only converts with Napi::CallbackInfo, so RawCall() falls back to it.
+template <>
+class TypeConvertor<Pair> {
+ public:
+  static Napi::Value ToJSValue(const Napi::CallbackInfo& info,
+                               const Pair& value) {
+    Napi::Array ret = Napi::Array::New(info.Env(), 2);
+    ret[uint32_t(0)] = Napi::Number::New(info.Env(), value.first);
+    ret[uint32_t(1)] = Napi::Number::New(info.Env(), value.second);
+    return ret;
+  }
+};
+
+}  // namespace node_binding
+
+double CAdd(double arg0, double arg1) { return arg0 + arg1; }
+
+std::string CConcat(const std::string& a, const std::string& b) {
+  return a + b;
+}
+
+int CSum8(int a, int b, int c, int d, int e, int f, int g, int h) {
+  return a + b + c + d + e + f + g + h;
+}
+
+std::vector<int> CLinSpace(int from, int to, int step) {
+  std::vector<int> ret;
+  for (int i = from; i < to; i += step) {
+    ret.push_back(i);
+  }
+  return ret;
+}
+
+Pair CMakePair(int first, int second) { return {first, second}; }
+
+int g_counter = 0;
+
+void CIncrement() { ++g_counter; }
+
+int CCounter() { return g_counter; }
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  exports.Set("add", NewRawFunction(env, "add", NODE_BINDING_MEMBER(&CAdd)));
+  exports.Set("concat",
+              NewRawFunction(env, "concat", NODE_BINDING_MEMBER(&CConcat)));
+  exports.Set("sum8",
+              NewRawFunction(env, "sum8", NODE_BINDING_MEMBER(&CSum8)));
+  exports.Set("linSpace", NewRawFunction(env, "linSpace",
+                                         NODE_BINDING_MEMBER(&CLinSpace)));
+  exports.Set("makePair", NewRawFunction(env, "makePair",
+                                         NODE_BINDING_MEMBER(&CMakePair)));
+  exports.Set("increment", NewRawFunction(env, "increment",
+                                          NODE_BINDING_MEMBER(&CIncrement)));
+  exports.Set("counter",
+              NewRawFunction(env, "counter", NODE_BINDING_MEMBER(&CCounter)));
+  return exports;
+}
+
+NODE_API_MODULE(9_raw_call, Init)
\ No newline at end of file
@@ -8,4 +8,25 @@ node-gyp rebuild -C test/2_constructor
 node-gyp rebuild -C test/3_instance_accessor
 node-gyp rebuild -C test/4_instance_method
 node-gyp rebuild -C test/5_static_method
-node-gyp rebuild -C test/6_stl
\ No newline at end of file
+node-gyp rebuild -C test/6_stl
+node-gyp rebuild -C test/7_member_view
+node-gyp rebuild -C test/8_class
+node-gyp rebuild -C test/9_raw_call
+node-gyp rebuild -C test/10_lazy_export
+node-gyp rebuild -C test/11_external_memory
+node-gyp rebuild -C test/12_reclaimer
+node-gyp rebuild -C test/13_function
+node-gyp rebuild -C test/14_coroutine
+node-gyp rebuild -C test/15_mapped_file
+node-gyp rebuild -C test/16_transfer
+node-gyp rebuild -C test/17_shared_memory
+node-gyp rebuild -C test/18_trace
+node-gyp rebuild -C test/19_iterable
+node-gyp rebuild -C test/20_variant
+node-gyp rebuild -C test/21_utf16
+node-gyp rebuild -C test/22_packed
+node-gyp rebuild -C test/23_arg_policy
+node-gyp rebuild -C test/24_object_pool
+node-gyp rebuild -C test/25_expected
+node-gyp rebuild -C test/26_array_buffer_fields
+node-gyp rebuild -C test/27_command_buffer
@@ -0,0 +1,8 @@
+{
+  "targets": [
+    {
+      "target_name": "counting_allocator",
+      "sources": ["counting_allocator.cc"],
+    }
+  ]
+}
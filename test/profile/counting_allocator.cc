@@ -0,0 +1,89 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Counts heap allocations of each thread, when it is preloaded with
+// LD_PRELOAD. Every allocation, including operator new of any library, ends
+// up in one of these. It forwards to the allocator of glibc.
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+
+// Same as in node_binding/profile.h.
+struct NodeBindingCounters {
+  uint64_t allocations;
+  uint64_t bytes;
+  uint64_t handles;
+};
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+}  // extern "C"
+
+namespace {
+
+// Initial-exec, so that it is accessed without allocating.
+__attribute__((tls_model("initial-exec"))) thread_local NodeBindingCounters
+    g_counters = {0, 0, 0};
+
+void* Count(void* ptr, size_t size) {
+  if (ptr != nullptr) {
+    ++g_counters.allocations;
+    g_counters.bytes += size;
+  }
+  return ptr;
+}
+
+}  // namespace
+
+extern "C" {
+
+__attribute__((visibility("default"))) NodeBindingCounters*
+node_binding_counters() {
+  return &g_counters;
+}
+
+__attribute__((visibility("default"))) void* malloc(size_t size) {
+  return Count(__libc_malloc(size), size);
+}
+
+__attribute__((visibility("default"))) void* calloc(size_t count,
+                                                    size_t size) {
+  return Count(__libc_calloc(count, size), count * size);
+}
+
+__attribute__((visibility("default"))) void* realloc(void* ptr, size_t size) {
+  return Count(__libc_realloc(ptr, size), size);
+}
+
+__attribute__((visibility("default"))) void* memalign(size_t alignment,
+                                                      size_t size) {
+  return Count(__libc_memalign(alignment, size), size);
+}
+
+__attribute__((visibility("default"))) void* aligned_alloc(size_t alignment,
+                                                           size_t size) {
+  return Count(__libc_memalign(alignment, size), size);
+}
+
+__attribute__((visibility("default"))) int posix_memalign(void** ptr,
+                                                          size_t alignment,
+                                                          size_t size) {
+  void* allocated = Count(__libc_memalign(alignment, size), size);
+  if (allocated == nullptr) return ENOMEM;
+  *ptr = allocated;
+  return 0;
+}
+
+__attribute__((visibility("default"))) void free(void* ptr) {
+  __libc_free(ptr);
+}
+
+}  // extern "C"
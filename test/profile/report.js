@@ -0,0 +1,171 @@
+// Copyright (c) 2019 The NodeBinding Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Summarizes traces written by addons built for profiling into allocations,
+// bytes and N-API handles per bound call.
+//
+//   node test/profile/report.js <dir> [--save <file>] [--baseline <file>]
+//
+// With --baseline, it fails if the fewest allocations or handles a binding
+// made in a call grew, which leaves out one-time initializations.
+
+const fs = require('fs');
+const path = require('path');
+
+const PHASES = ['ConvertArg', 'Native', 'ConvertResult'];
+
+const STRING = 'std::__cxx11::basic_string<char, std::char_traits<char>, ' +
+    'std::allocator<char> >';
+
+// Spells standard types as they are written.
+function simplify(type) {
+  let simplified = type.split(STRING).join('std::string');
+  // Drops default allocators, innermost first.
+  while (true) {
+    const next = simplified.replace(
+        /, std::(allocator|less|hash|equal_to)<[^<>]*> >/g, '>');
+    if (next == simplified) return simplified;
+    simplified = next;
+  }
+}
+
+// Shortens a signature of GCC or Clang to its template arguments, or to the
+// bound function of RawCall().
+function label(name, detail) {
+  const match = /\[with (.*)\]$/.exec(simplify(detail));
+  if (!match) return `${name} ${detail}`;
+  const params = match[1].split('; ').filter(
+      (param) => param != 'DefaultArgs = {}' &&
+          !param.startsWith('napi_env = '));
+  const f = params.find((param) => param.startsWith('F f = '));
+  if (f) return `${name} ${f.slice('F f = '.length)}`;
+  return `${name} <${params.join('; ')}>`;
+}
+
+function newStats() {
+  const stats = {calls: 0, min: null, total: {}, phases: {}};
+  for (const counter of ['allocations', 'bytes', 'handles']) {
+    stats.total[counter] = 0;
+  }
+  for (const phase of PHASES) stats.phases[phase] = 0;
+  return stats;
+}
+
+function addCall(stats, event, children) {
+  const {allocations, bytes, handles} = event.args;
+  ++stats.calls;
+  stats.total.allocations += allocations;
+  stats.total.bytes += bytes;
+  stats.total.handles += handles;
+  if (stats.min == null) {
+    stats.min = {allocations, handles};
+  } else {
+    stats.min.allocations = Math.min(stats.min.allocations, allocations);
+    stats.min.handles = Math.min(stats.min.handles, handles);
+  }
+  for (const child of children) {
+    if (child.name in stats.phases) {
+      stats.phases[child.name] += child.args.allocations;
+    }
+  }
+}
+
+// Returns stats of each span with a detail, keyed by addon and label.
+// Spans without a detail are the phases of the innermost call enclosing
+// them, which is recorded after them.
+function summarize(dir) {
+  const summary = {};
+  for (const file of fs.readdirSync(dir).sort()) {
+    const match = /^(.*)\.node\.\d+\.json$/.exec(file);
+    if (!match) continue;
+    const addon = match[1];
+    const trace = JSON.parse(fs.readFileSync(path.join(dir, file), 'utf8'));
+    const pending = new Map();
+    for (const event of trace.traceEvents) {
+      if (!('allocations' in event.args)) continue;
+      if (!pending.has(event.tid)) pending.set(event.tid, []);
+      const spans = pending.get(event.tid);
+      if (event.args.detail == null) {
+        spans.push(event);
+        continue;
+      }
+      const children = spans.filter((span) => span.ts >= event.ts);
+      pending.set(event.tid, spans.filter((span) => span.ts < event.ts));
+
+      summary[addon] = summary[addon] || {};
+      const key = label(event.name, event.args.detail);
+      summary[addon][key] = summary[addon][key] || newStats();
+      addCall(summary[addon][key], event, children);
+    }
+  }
+  return summary;
+}
+
+function print(summary) {
+  const perCall = (value, calls) => (value / calls).toFixed(2);
+  for (const addon of Object.keys(summary)) {
+    console.log(addon);
+    for (const [key, stats] of Object.entries(summary[addon])) {
+      const {calls, min, total, phases} = stats;
+      console.log(`  ${key}`);
+      console.log(
+          `    ${calls} calls, ` +
+          `allocations ${min.allocations} min ` +
+          `${perCall(total.allocations, calls)} avg ` +
+          `(args ${perCall(phases.ConvertArg, calls)}, ` +
+          `native ${perCall(phases.Native, calls)}, ` +
+          `result ${perCall(phases.ConvertResult, calls)}), ` +
+          `bytes ${perCall(total.bytes, calls)} avg, ` +
+          `handles ${min.handles} min ${perCall(total.handles, calls)} avg`);
+    }
+  }
+}
+
+// Returns bindings whose fewest allocations or handles per call grew.
+function compare(summary, baseline) {
+  const regressions = [];
+  for (const addon of Object.keys(summary)) {
+    for (const [key, stats] of Object.entries(summary[addon])) {
+      const base = baseline[addon] && baseline[addon][key];
+      if (!base) continue;
+      for (const counter of ['allocations', 'handles']) {
+        if (stats.min[counter] > base.min[counter]) {
+          regressions.push(`${addon} ${key}: ${counter} ` +
+                           `${base.min[counter]} -> ${stats.min[counter]}`);
+        }
+      }
+    }
+  }
+  return regressions;
+}
+
+function main(args) {
+  const dir = args[0];
+  const option = (name) => {
+    const i = args.indexOf(name);
+    return i >= 0 ? args[i + 1] : null;
+  };
+  if (!dir) {
+    console.error('Usage: report.js <dir> [--save <file>] [--baseline <file>]');
+    return 2;
+  }
+
+  const summary = summarize(dir);
+  print(summary);
+  if (option('--save')) {
+    fs.writeFileSync(option('--save'), JSON.stringify(summary, null, 2));
+  }
+  if (option('--baseline')) {
+    const baseline = JSON.parse(fs.readFileSync(option('--baseline'), 'utf8'));
+    const regressions = compare(summary, baseline);
+    if (regressions.length > 0) {
+      console.error('Allocations per call grew:');
+      for (const regression of regressions) console.error(`  ${regression}`);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+process.exitCode = main(process.argv.slice(2));
@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+
+# Counts heap allocations and N-API handles per bound call while running the
+# tests, or the benchmarks, and reports them. It relies on LD_PRELOAD, so it
+# works on Linux. Addons are left built for profiling, rebuild them after.
+#
+#   test/profile/run.sh [test|benchmark] [--save <file>] [--baseline <file>]
+
+set -e
+
+suite=${1:-test}
+shift || true
+root=$(pwd)
+out=$(mktemp -d)
+
+node-gyp rebuild -C test/profile
+CXXFLAGS="-DNODE_BINDING_PROFILING -include $root/node_binding/profile.h" \
+  ./$suite/build_all.sh
+
+export LD_PRELOAD=$root/test/profile/build/Release/counting_allocator.node
+export NODE_BINDING_PROFILE=$out
+if [ "$suite" = test ]; then
+  node node_modules/mocha/bin/mocha
+else
+  for dir in benchmark/*/; do
+    # Harnesses built by bazel, e.g. benchmark/scaling, are skipped.
+    [ -f $dir/binding.gyp ] || continue
+    node $dir
+  done
+fi
+unset LD_PRELOAD NODE_BINDING_PROFILE
+
+node test/profile/report.js $out "$@"
+rm -rf $out
@@ -3,6 +3,10 @@
 // found in the LICENSE file.
 
 const assert = require('assert');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const {Worker} = require('worker_threads');
 const test0 = require('./0_function/build/Release/0_function.node');
 const test1 =
     require('./1_default_argument/build/Release/1_default_argument.node');
@@ -13,6 +17,42 @@ const test4 =
     require('./4_instance_method/build/Release/4_instance_method.node');
 const test5 = require('./5_static_method/build/Release/5_static_method.node');
 const test6 = require('./6_stl/build/Release/6_stl.node');
+const test7 = require('./7_member_view/build/Release/7_member_view.node');
+const test8 = require('./8_class/build/Release/8_class.node');
+const test9 = require('./9_raw_call/build/Release/9_raw_call.node');
+const test10 = require('./10_lazy_export/build/Release/10_lazy_export.node');
+const test11 =
+    require('./11_external_memory/build/Release/11_external_memory.node');
+const test12 = require('./12_reclaimer/build/Release/12_reclaimer.node');
+const test13 = require('./13_function/build/Release/13_function.node');
+const test14 = require('./14_coroutine/build/Release/14_coroutine.node');
+const test15 = require('./15_mapped_file/build/Release/15_mapped_file.node');
+const test16 = require('./16_transfer/build/Release/16_transfer.node');
+const test17 =
+    require('./17_shared_memory/build/Release/17_shared_memory.node');
+const test18 = require('./18_trace/build/Release/18_trace.node');
+const test19 = require('./19_iterable/build/Release/19_iterable.node');
+const test20 = require('./20_variant/build/Release/20_variant.node');
+const test21 = require('./21_utf16/build/Release/21_utf16.node');
+const test22 = require('./22_packed/build/Release/22_packed.node');
+const test23 = require('./23_arg_policy/build/Release/23_arg_policy.node');
+const test24 = require('./24_object_pool/build/Release/24_object_pool.node');
+const test25 = require('./25_expected/build/Release/25_expected.node');
+const test26 =
+    require('./26_array_buffer_fields/build/Release/26_array_buffer_fields.node');
+const test27 =
+    require('./27_command_buffer/build/Release/27_command_buffer.node');
+
+require('v8').setFlagsFromString('--expose-gc');
+const gc = require('vm').runInNewContext('gc');
+
+// Collects garbage until native finalizers, which may be deferred, run.
+async function collectGarbage() {
+  for (let i = 0; i < 10; ++i) {
+    gc();
+    await new Promise((resolve) => setImmediate(resolve));
+  }
+}
 
 describe('0_function', () => {
   it('add(int arg0, int arg1) bind', () => {
@@ -80,5 +120,1069 @@ describe('6_stl', () => {
   it('std::vector<int> bind', () => {
     assert.equal(test6.sum([1, 2, 3]), 6);
     assert.deepEqual(test6.linSpace(1, 5, 1), [1, 2, 3, 4]);
+    assert.throws(() => {
+      test6.sum([1, '2', 3]);
+    }, /arg0/);
+  });
+
+  it('std::map<K, V> and std::unordered_map<K, V> bind', () => {
+    const counts = test6.countWords(['a', 'b', 'a']);
+    assert.deepEqual(counts, {a: 2, b: 1});
+    assert.deepEqual(Object.keys(counts), ['a', 'b']);
+    counts.a = 3;
+    assert.equal(counts.a, 3);
+
+    const inverted = test6.invert({one: 1, two: 2});
+    assert.ok(inverted instanceof Map);
+    assert.deepEqual([...inverted].sort(), [[1, 'one'], [2, 'two']]);
+
+    assert.equal(test6.lookup({a: 1, b: 2}, 'b'), 2);
+    assert.equal(test6.lookup(new Map([['a', 1]]), 'a'), 1);
+    assert.equal(test6.lookup({}, 'a'), -1);
+    assert.deepEqual(test6.sumEach({a: [1, 2], b: []}), {a: 3, b: 0});
+    assert.deepEqual(test6.sumEach(new Map([['c', [3]]])), {c: 3});
+    for (const invalid of [{a: '1'}, new Map([[1, 1]]), [1], new Set(), 1]) {
+      assert.throws(() => {
+        test6.lookup(invalid, 'a');
+      }, /arg0/);
+    }
+    assert.throws(() => {
+      test6.sumEach({a: [1, 'x']});
+    }, /arg0/);
+    assert.throws(() => {
+      test6.lookup({get a() { throw new Error('getter'); }}, 'a');
+    }, /getter/);
+  });
+
+  it('std::set<T> and std::unordered_set<T> bind', () => {
+    const unique = test6.unique([3, 1, 3, 2]);
+    assert.ok(unique instanceof Set);
+    assert.deepEqual([...unique], [1, 2, 3]);
+    assert.equal(test6.sumSet(new Set([1, 2, 3])), 6);
+    assert.equal(test6.sumSet([1, 1, 2]), 3);
+    assert.throws(() => {
+      test6.sumSet(new Set(['1']));
+    }, /arg0/);
+    assert.throws(() => {
+      test6.sumSet({});
+    }, /arg0/);
+  });
+});
+
+describe('7_member_view', () => {
+  it('Rect.topLeft and Rect.bottomRight bind as views', () => {
+    const r = new test7.Rect();
+    assert.equal(r.area(), 0);
+    r.topLeft.y = 5;
+    r.bottomRight.x = 2;
+    assert.equal(r.topLeft.y, 5);
+    assert.equal(r.bottomRight.x, 2);
+    assert.equal(r.area(), 10);
+    assert.strictEqual(r.topLeft, r.topLeft);
+    assert.notStrictEqual(r.topLeft, r.bottomRight);
+    assert.ok(r.topLeft instanceof test7.Point);
+  });
+
+  it('Externals from JS are not taken as members', () => {
+    const p = new test7.Point(test7.newExternal(), {});
+    p.x = 1;
+    assert.equal(p.x, 1);
+    assert.equal(new test7.Point(test7.newExternal(), {}).x, 0);
+  });
+
+  it('A view keeps its owner alive', async () => {
+    let owner;
+    const view = (() => {
+      const r = new test7.Rect();
+      owner = new WeakRef(r);
+      r.bottomRight.x = 3;
+      r.bottomRight.y = -4;
+      return r.bottomRight;
+    })();
+    await collectGarbage();
+    // Reuses memory freed by the collection.
+    const others = [...Array(100)].map(() => new test7.Rect());
+    others.forEach((r) => r.bottomRight.x = 7);
+    assert.ok(owner.deref() !== undefined);
+    assert.equal(view.x, 3);
+    assert.equal(view.y, -4);
+    view.x = 5;
+    assert.equal(view.x, 5);
+    assert.strictEqual(owner.deref().bottomRight, view);
+    assert.equal(owner.deref().area(), 20);
+  });
+});
+
+describe('8_class', () => {
+  it('Class<Point> bind', () => {
+    const p = new test8.Point();
+    assert.equal(p.x, 0);
+    p.x = 3;
+    assert.equal(p.x, 3);
+    assert.throws(() => {
+      p.x = 'a';
+    });
+    const p2 = new test8.Point(1, 2);
+    assert.equal(p2.y, 2);
+    assert.throws(() => {
+      new test8.Point(1);
+    });
+  });
+
+  it('Class<Line> bind', () => {
+    const l = new test8.Line(new test8.Point(1, 2), new test8.Point(4, 6));
+    assert.equal(l.length(), 7);
+    assert.ok(l.from instanceof test8.Point);
+    assert.equal(l.to.y, 6);
+    l.from = new test8.Point(4, 2);
+    assert.equal(l.length(), 4);
+    assert.throws(() => {
+      l.from = {x: 1, y: 2};
+    });
+    assert.throws(() => {
+      test8.Line.prototype.length.call({});
+    });
+  });
+
+  it('Class<Calculator> bind', () => {
+    assert.equal(test8.Calculator.add(1, 2), 3);
+    const c = new test8.Calculator(5);
+    c.increment(2);
+    assert.equal(c.result(), 7);
+    c.clear();
+    assert.equal(c.result(), 0);
+  });
+
+  it('Constructors check types of arguments', () => {
+    assert.throws(() => new test8.Point('a', {}), TypeError);
+    assert.throws(() => new test8.Line({}, {}), TypeError);
+    assert.throws(() => new test8.Calculator('5'), TypeError);
+  });
+
+  it('Externals are not taken as native objects', () => {
+    const external = test8.newExternal();
+    assert.throws(() => new test8.Point(external), TypeError);
+    assert.throws(() => new test8.Calculator(external), TypeError);
+    assert.equal(new test8.Calculator(3).result(), 3);
+  });
+
+  it('Objects of other classes are rejected', () => {
+    const calculator = new test8.Calculator(1);
+    const getX =
+        Object.getOwnPropertyDescriptor(test8.Point.prototype, 'x').get;
+    assert.throws(() => getX.call(calculator), TypeError);
+    assert.throws(
+        () => new test8.Line(calculator, new test8.Point(1, 2)), TypeError);
+    assert.throws(
+        () => test8.Calculator.prototype.result.call(new test8.Point()),
+        TypeError);
+  });
+});
+
+describe('9_raw_call', () => {
+  it('RawCall() bind', () => {
+    assert.equal(test9.add(1, 2), 3);
+    assert.throws(() => {
+      test9.add(1);
+    });
+    assert.throws(() => {
+      test9.add(1, 2, 3);
+    });
+    assert.throws(() => {
+      test9.add(1, 'a');
+    });
+    assert.equal(test9.concat('a', 'b'), 'ab');
+    assert.equal(test9.sum8(1, 2, 3, 4, 5, 6, 7, 8), 36);
+    assert.deepEqual(test9.linSpace(1, 5, 1), [1, 2, 3, 4]);
+    assert.deepEqual(test9.makePair(1, 2), [1, 2]);
+    assert.strictEqual(test9.increment(), undefined);
+    assert.equal(test9.counter(), 1);
+  });
+});
+
+describe('10_lazy_export', () => {
+  it('LazyExport defines once on first access', () => {
+    assert.ok(Object.keys(test10).includes('Point'));
+    assert.equal(test10.numDefinitions(), 0);
+    const p = test10.newPoint();
+    assert.equal(test10.numDefinitions(), 1);
+    assert.ok(p instanceof test10.Point);
+    assert.strictEqual(test10.Point, test10.Point);
+    assert.equal(test10.numDefinitions(), 1);
+    assert.equal(new test10.Point(1, 2).y, 2);
+    assert.equal(test10.add(1, 2), 3);
+    assert.equal(test10.numDefinitions(), 2);
+  });
+
+  it('LazyExport defines once per env', () => {
+    const worker = new Worker(`
+      const {parentPort, workerData} = require('worker_threads');
+      const binding = require(workerData);
+      new binding.Point();
+      new binding.Point();
+      parentPort.postMessage(binding.numDefinitions());
+    `, {
+      eval: true,
+      workerData: require.resolve(
+          './10_lazy_export/build/Release/10_lazy_export.node'),
+    });
+    return new Promise((resolve, reject) => {
+      worker.on('message', resolve);
+      worker.on('error', reject);
+    }).then((numDefinitions) => {
+      assert.equal(numDefinitions, 3);
+      assert.equal(new test10.Point(3, 4).x, 3);
+    });
+  });
+});
+
+describe('11_external_memory', () => {
+  const MB = 1024 * 1024;
+
+  it('Class<Blob> reports its external memory', async () => {
+    const base = test11.externalMemory();
+    (() => {
+      const b = new test11.Blob(MB);
+      assert.ok(test11.externalMemory() - base >= MB);
+      b.resize(4 * MB);
+      assert.ok(test11.externalMemory() - base >= 4 * MB);
+      b.resize(0);
+      assert.ok(test11.externalMemory() - base < MB);
+      b.resize(2 * MB);
+    })();
+    await collectGarbage();
+    assert.ok(test11.externalMemory() - base < MB);
+  });
+
+  it('ExternalMemory reports for a hand-written ObjectWrap', async () => {
+    const base = test11.externalMemory();
+    (() => {
+      const b = new test11.HandWrittenBlob(MB);
+      assert.ok(test11.externalMemory() - base >= MB);
+      b.resize(3 * MB);
+      assert.ok(test11.externalMemory() - base >= 3 * MB);
+    })();
+    await collectGarbage();
+    assert.ok(test11.externalMemory() - base < MB);
+  });
+
+  it('NewExternalArrayBuffer() reports its external memory', async () => {
+    const base = test11.externalMemory();
+    (() => {
+      const buffer = test11.newBuffer(2 * MB);
+      assert.equal(buffer.byteLength, 2 * MB);
+      assert.equal(new Uint8Array(buffer)[MB], 1);
+      const reported = test11.externalMemory() - base;
+      assert.ok(reported >= 2 * MB && reported < 3 * MB);
+    })();
+    await collectGarbage();
+    assert.ok(test11.externalMemory() - base < MB);
+  });
+});
+
+describe('12_reclaimer', () => {
+  it('Deferred objects are destroyed on the reclaimer thread', async () => {
+    const before = test12.stats();
+    (() => {
+      for (let i = 0; i < 10; ++i) {
+        assert.equal(new test12.Tree(1000).size(), 1000);
+        assert.equal(new test12.HandWrittenTree(1000).size(), 1000);
+        assert.equal(new test12.JSThreadTree(1000).size(), 1000);
+      }
+    })();
+    await collectGarbage();
+    test12.flush();
+    const after = test12.stats();
+    assert.equal(after.offJSThread - before.offJSThread, 20);
+    assert.equal(after.onJSThread - before.onJSThread, 10);
+    assert.equal(after.enqueued - before.enqueued, 20);
+    assert.equal(after.reclaimed - before.reclaimed, 20);
+    assert.equal(after.pending, 0);
+    assert.ok(after.maxPending > 0);
+  });
+
+  it('Objects are destroyed on the JS thread if the queue is full',
+     async () => {
+       const before = test12.stats();
+       test12.setCapacity(0);
+       (() => {
+         for (let i = 0; i < 10; ++i) new test12.Tree(1000);
+       })();
+       await collectGarbage();
+       test12.setCapacity(1024);
+       const after = test12.stats();
+       assert.equal(after.overflowed - before.overflowed, 10);
+       assert.equal(after.onJSThread - before.onJSThread, 10);
+     });
+});
+
+describe('13_function', () => {
+  it('FunctionRef<R(Args...)> bind', () => {
+    assert.deepEqual(test13.sort([3, 1, 2], (a, b) => a < b), [1, 2, 3]);
+    assert.deepEqual(test13.sort([3, 1, 2], (a, b) => a > b), [3, 2, 1]);
+    const visited = [];
+    test13.forEach(['a', 'b'], (value, i) => visited.push([value, i]));
+    assert.deepEqual(visited, [['a', 0], ['b', 1]]);
+    assert.throws(() => {
+      test13.sort([3, 1, 2], 1);
+    });
+    assert.throws(() => {
+      test13.sort([3, 1, 2], (a, b) => 'a');
+    }, /Type of return value is mismatched/);
+    let calls = 0;
+    assert.throws(() => {
+      test13.sort([5, 4, 3, 2, 1], (a, b) => {
+        ++calls;
+        throw new Error('compare');
+      });
+    }, /compare/);
+    assert.equal(calls, 1);
+  });
+
+  it('std::function<R(Args...)> bind', () => {
+    let base = 10;
+    test13.setCallback((value) => base + value);
+    assert.equal(test13.runCallback(1), 11);
+    base = 20;
+    assert.equal(test13.runCallback(2), 22);
+    test13.clearCallback();
+  });
+});
+
+describe('14_coroutine', () => {
+  it('Task<T> bind', async () => {
+    const sum = test14.add(Promise.resolve(1), 2);
+    assert.ok(sum instanceof Promise);
+    assert.equal(await sum, 3);
+    assert.equal(await test14.fib(20), 6765);
+    await test14.check(1);
+    assert.equal(test14.countAlive(), 0);
+  });
+
+  it('Task<T> alternates background work and JS callbacks', async () => {
+    const steps = [];
+    const results = await test14.pipeline([1, 2, 3], (value) => {
+      steps.push(value);
+      return value + 1;
+    });
+    assert.deepEqual(steps, [1, 4, 9]);
+    assert.deepEqual(results, [2, 5, 10]);
+    assert.equal(test14.countAlive(), 0);
+  });
+
+  it('Task<T> is rejected', async () => {
+    await assert.rejects(
+        test14.add(Promise.reject(new Error('a')), 1), /^Error: a$/);
+    await assert.rejects(
+        test14.add(1, 'b'), /Type of resolved value is mismatched/);
+    await assert.rejects(test14.check(-1), RangeError);
+    await assert.rejects(test14.pipeline([1, 2], (value) => {
+      throw new Error('step');
+    }), /step/);
+    assert.equal(test14.countAlive(), 0);
+  });
+});
+
+describe('15_mapped_file', () => {
+  const file = path.join(os.tmpdir(), `node_binding_${process.pid}.bin`);
+
+  beforeEach(() => {
+    fs.writeFileSync(file, Buffer.from(new Float32Array([1, 2, 3, 4]).buffer));
+  });
+
+  afterEach(() => {
+    fs.unlinkSync(file);
+  });
+
+  it('MappedFile bind', () => {
+    const buffer = test15.open(file, false);
+    assert.ok(buffer instanceof ArrayBuffer);
+    assert.deepEqual(Buffer.from(buffer), fs.readFileSync(file));
+    assert.equal(test15.checksum(buffer), test15.checksum(
+        new Uint8Array(fs.readFileSync(file))));
+    assert.equal(test15.slice(file, 4, 8).byteLength, 8);
+    assert.deepEqual(Buffer.from(test15.slice(file, 4, 8)),
+                     fs.readFileSync(file).subarray(4, 12));
+    assert.equal(test15.slice(file, 12, 8).byteLength, 4);
+    assert.equal(test15.open(`${file}.missing`, false), null);
+  });
+
+  it('MappedFile honors read-only', () => {
+    const original = fs.readFileSync(file);
+    const [first, second] = test15.openTwice(file);
+    new Uint8Array(first)[0] = 0xff;
+    test15.fill(new Uint8Array(first, 1, 3), 0xff);
+    assert.deepEqual(Buffer.from(first, 0, 4), Buffer.alloc(4, 0xff));
+    assert.deepEqual(Buffer.from(second), original);
+    assert.equal(test15.checksum(test15.open(file, false)),
+                 test15.checksum(new Uint8Array(original)));
+    assert.deepEqual(fs.readFileSync(file), original);
+
+    const writable = test15.open(file, true);
+    test15.fill(new Uint8Array(writable, 0, 4), 0);
+    assert.deepEqual(fs.readFileSync(file).subarray(0, 4), Buffer.alloc(4));
+  });
+
+  it('MappedArray<T> bind', () => {
+    const values = test15.openFloats(file, 0);
+    assert.ok(values instanceof Float32Array);
+    assert.deepEqual(Array.from(values), [1, 2, 3, 4]);
+    assert.equal(test15.sum(values), 10);
+    assert.equal(test15.sum(test15.openFloats(file, 8)), 7);
+    assert.throws(() => {
+      test15.openFloats(file, 1);
+    }, RangeError);
+    assert.throws(() => {
+      test15.sum(new Float64Array(1));
+    }, /Type of arg0 is mismatched/);
+  });
+});
+
+describe('16_transfer', () => {
+  // Runs |source| in a worker, which gets the binding as |binding| and
+  // |token| from the main thread, and posts back what it returns.
+  function runInWorker(source, token) {
+    const worker = new Worker(`
+      const {parentPort, workerData} = require('worker_threads');
+      const binding = require(workerData.path);
+      const token = workerData.token;
+      parentPort.postMessage((() => { ${source} })());
+    `, {
+      eval: true,
+      workerData: {
+        path: require.resolve('./16_transfer/build/Release/16_transfer.node'),
+        token,
+      },
+    });
+    return new Promise((resolve, reject) => {
+      worker.on('message', resolve);
+      worker.on('error', reject);
+    });
+  }
+
+  it('Class<T> objects are moved between workers', async () => {
+    const copies = test16.counts().copies;
+    const matrix = new test16.Matrix(100, 100);
+    const sum = matrix.sum();
+    const token = matrix.detach();
+    assert.throws(() => {
+      matrix.sum();
+    }, /Illegal invocation/);
+
+    const result = await runInWorker(`
+      const matrix = binding.Matrix.adopt(token);
+      const sum = matrix.sum();
+      matrix.scale(2);
+      return {sum, token: matrix.detach()};
+    `, token);
+    assert.equal(result.sum, sum);
+    assert.equal(test16.Matrix.adopt(result.token).sum(), sum * 2);
+    assert.throws(() => {
+      test16.Matrix.adopt(result.token);
+    }, /Invalid transfer token/);
+    assert.equal(test16.counts().copies, copies);
+    assert.equal(test16.counts().pending, 0);
+  });
+
+  it('Class<T> objects are shared between workers', async () => {
+    const copies = test16.counts().copies;
+    const matrix = new test16.Matrix(10, 10);
+    const sum = await runInWorker(`
+      return binding.Matrix.adopt(token).sum();
+    `, matrix.share());
+    assert.equal(sum, matrix.sum());
+    assert.equal(matrix.rows(), 10);
+    assert.equal(test16.counts().copies, copies);
+
+    const movable = new test16.MovableMatrix(10, 10);
+    assert.equal(movable.share, undefined);
+    const token = movable.detach();
+    assert.throws(() => {
+      test16.Matrix.adopt(token);
+    }, /Invalid transfer token/);
+    assert.equal(test16.MovableMatrix.adopt(token).sum(), 4950);
+    assert.throws(() => {
+      test16.Matrix.adopt('1');
+    }, /Invalid transfer token/);
+  });
+});
+
+describe('17_shared_memory', () => {
+  it('Span<T> bind SharedArrayBuffer', () => {
+    const buffer = new SharedArrayBuffer(4);
+    new Uint8Array(buffer).set([1, 2, 3, 4]);
+    assert.equal(test17.checksum(buffer), 10);
+    assert.equal(test17.checksum(new Uint8Array(buffer, 2)), 7);
+    assert.throws(() => {
+      test17.checksum({});
+    }, /Type of arg0 is mismatched/);
+  });
+
+  it('SharedRingBuffer<T> bind', () => {
+    const queue = test17.newQueue(3);
+    assert.ok(queue.buffer instanceof SharedArrayBuffer);
+    for (let i = 0; i < 4; ++i) assert.ok(test17.push(queue, i));
+    assert.ok(!test17.push(queue, 4));
+    assert.deepEqual(test17.drain(queue), [0, 1, 2, 3]);
+    assert.ok(test17.push(queue, 5));
+    assert.deepEqual(test17.drain(queue), [5]);
+    assert.throws(() => {
+      test17.push(new Uint8Array(1024), 0);
+    }, /Type of arg0 is mismatched/);
+  });
+
+  it('SharedRingBuffer<T> keeps its capacity if JS changes it', () => {
+    // A queue of 4 int32 in room for 8, whose extra slots are ready to be
+    // pushed into. A header takes 192 bytes, and a slot 8.
+    const queue = new Uint8Array(new SharedArrayBuffer(192 + 8 * 8));
+    queue.set(test17.newQueue(4));
+    const slots = new Int32Array(queue.buffer, 192);
+    for (let i = 4; i < 8; ++i) slots[2 * i] = i;
+    const counters = test17.newCounters(2);
+    // Blocks after filling the queue.
+    test17.produceInBackground(queue, counters, 0, 8);
+    while (Atomics.load(counters, 1) < 4);
+
+    const header = new DataView(queue.buffer);
+    header.setUint32(8, 1 << 20, true);
+    Atomics.wait(new Int32Array(new SharedArrayBuffer(4)), 0, 0, 50);
+    assert.equal(Atomics.load(counters, 1), 4);
+
+    header.setUint32(8, 4, true);
+    const values = [];
+    while (values.length < 8) values.push(...test17.drain(queue));
+    test17.joinProducers();
+    assert.deepEqual(values, [0, 1, 2, 3, 4, 5, 6, 7]);
+  });
+
+  it('SharedRingBuffer<T> is shared by workers and native threads',
+     async () => {
+       const queue = test17.newQueue(4096);
+       const counters = test17.newCounters(2);
+       test17.produceInBackground(queue, counters, 1000, 1000);
+       const workers = [0, 500].map((from) => new Worker(`
+         const {parentPort, workerData} = require('worker_threads');
+         const binding = require(workerData.path);
+         const {queue, counters, from} = workerData;
+         for (let i = from; i < from + 500; ++i) {
+           while (!binding.push(queue, i));
+           Atomics.add(counters, 0, 1);
+         }
+         parentPort.postMessage(binding.count(counters, 0, 0));
+       `, {
+         eval: true,
+         workerData: {
+           path: require.resolve(
+               './17_shared_memory/build/Release/17_shared_memory.node'),
+           queue,
+           counters,
+           from,
+         },
+       }));
+       await Promise.all(workers.map((worker) => new Promise(
+           (resolve, reject) => {
+             worker.on('message', resolve);
+             worker.on('error', reject);
+           })));
+       test17.joinProducers();
+
+       assert.equal(Atomics.load(counters, 0), 1000);
+       assert.equal(Atomics.load(counters, 1), 1000);
+       const values = test17.drain(queue).sort((a, b) => a - b);
+       assert.deepEqual(values, Array.from({length: 2000}, (_, i) => i));
+     });
+});
+
+describe('18_trace', () => {
+  const file = path.join(os.tmpdir(), `node_binding_${process.pid}.json`);
+
+  // Returns recorded events grouped by thread.
+  function flushTrace() {
+    assert.ok(test18.flushTrace(file));
+    const trace = JSON.parse(fs.readFileSync(file, 'utf8'));
+    fs.unlinkSync(file);
+    const threads = new Map();
+    for (const event of trace.traceEvents) {
+      assert.equal(event.ph, 'X');
+      assert.equal(event.pid, process.pid);
+      if (!threads.has(event.tid)) threads.set(event.tid, []);
+      threads.get(event.tid).push(event);
+    }
+    return threads;
+  }
+
+  it('Tracer records spans of calls', async () => {
+    flushTrace();
+    test18.startTracing(1024);
+    assert.deepEqual(test18.range(3), [0, 1, 2]);
+    assert.equal(test18.multiply(2, 3), 6);
+    assert.equal(new test18.Counter(1).add(2), 3);
+    await collectGarbage();
+    test18.traceInThreads(2);
+    test18.stopTracing();
+    test18.range(1);
+
+    const threads = flushTrace();
+    const events = threads.get(Math.min(...threads.keys()));
+    const names = events.map((event) => event.name);
+    // Spans are recorded when they end, so a call follows its parts.
+    const range = events.findIndex(
+        (event) => event.name == 'TypedCall' &&
+            event.args.detail.includes('std::vector<int>'));
+    assert.deepEqual(names.slice(range - 3, range + 1),
+                     ['ConvertArg', 'Native', 'ConvertResult', 'TypedCall']);
+    // Timestamps are in microseconds, rounded to nanoseconds.
+    const precedes = (a, b) => a.ts + a.dur <= b.ts + 0.001;
+    const [arg, native, result, call] = events.slice(range - 3, range + 1);
+    assert.ok(arg.ts >= call.ts && precedes(arg, native));
+    assert.ok(precedes(native, result));
+    assert.ok(result.ts + result.dur <= call.ts + call.dur + 0.001);
+    assert.match(call.args.detail, /TypedCall/);
+
+    const raw = events.find((event) => event.name == 'RawCall');
+    assert.match(raw.args.detail, /Multiply/);
+    assert.ok(names.includes('TypedConstruct'));
+    assert.ok(names.includes('Finalize'));
+    // range() isn't traced after stopTracing().
+    assert.equal(events.filter((event) => event.args.detail &&
+                                   event.args.detail.includes(
+                                       'std::vector<int>')).length,
+                 1);
+
+    const work = [...threads.values()].filter(
+        (events) => events.length == 1 && events[0].name == 'Work');
+    assert.equal(work.length, 2);
+    // Buffers of exited threads are released.
+    test18.startTracing(1024);
+    test18.traceInThreads(1);
+    test18.stopTracing();
+    assert.equal(flushTrace().size, 2);
+  });
+
+  it('Tracer keeps the latest spans of each thread', async () => {
+    test18.startTracing(4);
+    const worker = new Worker(`
+      const {parentPort, workerData} = require('worker_threads');
+      const binding = require(workerData);
+      for (let i = 0; i < 10; ++i) binding.range(i);
+      parentPort.postMessage(null);
+    `, {
+      eval: true,
+      workerData: require.resolve('./18_trace/build/Release/18_trace.node'),
+    });
+    await new Promise((resolve, reject) => {
+      worker.on('message', resolve);
+      worker.on('error', reject);
+    });
+    await worker.terminate();
+    test18.stopTracing();
+
+    const threads = flushTrace();
+    const events = threads.get(Math.max(...threads.keys()));
+    assert.deepEqual(events.map((event) => event.name),
+                     ['ConvertArg', 'Native', 'ConvertResult', 'TypedCall']);
+  });
+});
+
+describe('19_iterable', () => {
+  it('Iterable<Iterator> converts elements on demand', () => {
+    const squares = test19.squares(5);
+    assert.equal(typeof squares.next, 'function');
+    assert.strictEqual(squares[Symbol.iterator](), squares);
+    assert.deepEqual([...squares], [0, 1, 4, 9, 16]);
+    assert.deepEqual(squares.next(), {value: undefined, done: true});
+    assert.deepEqual([...test19.squares(0)], []);
+
+    let reads = test19.reads();
+    const numbers = [];
+    for (const number of test19.count(1e9)) {
+      if (number == 3) break;
+      numbers.push(number);
+    }
+    assert.deepEqual(numbers, [0, 1, 2]);
+    assert.ok(test19.reads() - reads <= 16);
+
+    reads = test19.reads();
+    let sum = 0;
+    for (const number of test19.count(10000)) sum += number;
+    assert.equal(sum, 10000 * 9999 / 2);
+    assert.equal(test19.reads() - reads, 10000);
+  });
+
+  it('Iterable<Iterator> keeps its owner alive', async () => {
+    await collectGarbage();
+    const alive = test19.alivePlaylists();
+    const songs = (() => {
+      const playlist = new test19.Playlist();
+      playlist.add('a');
+      playlist.add('b');
+      return playlist.songs();
+    })();
+    await collectGarbage();
+    assert.equal(test19.alivePlaylists(), alive + 1);
+    assert.deepEqual(songs.next(), {value: 'a', done: false});
+    assert.deepEqual([...songs], ['b']);
+
+    // The owner is released once exhausted or closed, even though the
+    // iterator is still reachable.
+    await collectGarbage();
+    assert.equal(test19.alivePlaylists(), alive);
+
+    const closed = (() => {
+      const playlist = new test19.Playlist();
+      playlist.add('c');
+      return playlist.songs();
+    })();
+    for (const song of closed) {
+      assert.equal(song, 'c');
+      break;
+    }
+    await collectGarbage();
+    assert.equal(test19.alivePlaylists(), alive);
+    assert.deepEqual(closed.next(), {value: undefined, done: true});
+  });
+});
+
+describe('20_variant', () => {
+  it('std::variant picks an alternative by typeof', () => {
+    const checks = test20.pointChecks();
+    assert.equal(test20.describe(3), 'int 3');
+    assert.equal(test20.describe('abc'), 'string abc');
+    assert.equal(test20.describe([1, 2]), 'vector of 2');
+    // Numbers and strings never reach the convertor of Point.
+    assert.equal(test20.pointChecks(), checks);
+    assert.equal(test20.describe({x: 1, y: 2}), 'point 1,2');
+    assert.throws(() => test20.describe(true), TypeError);
+    assert.throws(() => test20.describe({x: 1}), TypeError);
+    // Only typeof is checked, so no alternative takes it when converting.
+    assert.equal(test20.describeTrusted({x: 1, y: 2}), 'point 1,2');
+    assert.throws(() => test20.describeTrusted({}), TypeError);
+
+    assert.equal(test20.mirror(4), 4);
+    assert.deepEqual(test20.mirror([5]), [5]);
+    assert.deepEqual(test20.mirror({x: 1, y: 2}), {x: 2, y: 1});
+    assert.strictEqual(test20.parse('1.5'), 1.5);
+    assert.strictEqual(test20.parse('abc'), 'abc');
+    assert.strictEqual(test20.parse(''), undefined);
+  });
+
+  it('std::optional takes undefined and null', () => {
+    assert.equal(test20.greet('node'), 'hello node');
+    assert.equal(test20.greet(undefined), 'hello world');
+    assert.equal(test20.greet(null), 'hello world');
+    assert.throws(() => test20.greet(1), TypeError);
+    assert.strictEqual(test20.find([4, 5, 6], 5), 1);
+    assert.strictEqual(test20.find([4, 5, 6], 7), undefined);
+  });
+});
+
+describe('21_utf16', () => {
+  it('std::u16string bind', () => {
+    assert.equal(test21.reverse('abc'), 'cba');
+    assert.equal(test21.reverse(''), '');
+    assert.equal(test21.reverse('\u00e9\u4e2d'), '\u4e2d\u00e9');
+    assert.throws(() => test21.reverse(1), TypeError);
+  });
+
+  it('std::u16string_view bind', () => {
+    // Lengths are in UTF-16 code units, like in JS.
+    assert.equal(test21.length('a\u{1f600}'), 3);
+    assert.equal(test21.concat('ab', 'cd'), 'abcd');
+    assert.equal(test21.concat('long enough to grow', ''),
+                 'long enough to grow');
+    assert.equal(test21.concat('', 'x'), 'x');
+    assert.equal(
+        test21.around('ab', (text) => test21.concat(text, 'cd') + '-'),
+        'abcd-ab');
+
+    const text = new test21.Text('\u4e2d\u6587');
+    assert.equal(text.size(), 2);
+    assert.equal(text.view(), '\u4e2d\u6587');
+  });
+});
+
+describe('22_packed', () => {
+  it('Packed<T> is decoded from one buffer', () => {
+    const scene = test22.makeScene(2, 2);
+    assert.deepEqual(scene, {
+      name: 'scene',
+      version: 1,
+      layers: [
+        {
+          label: 'layer 0',
+          visible: true,
+          opacity: 0.5,
+          points: [{x: 0, y: 0}, {x: 0, y: 1}],
+          mask: [1, 2, 3],
+        },
+        {
+          label: 'layer 1',
+          visible: false,
+          opacity: 0.5,
+          points: [{x: 1, y: 0}, {x: 1, y: 1}],
+          mask: [1, 2, 3],
+        },
+      ],
+      tags: ['a', '\u00e9'],
+    });
+    assert.deepEqual(test22.makeScene(0, 0).layers, []);
+  });
+
+  it('Packed<T> is encoded from an object or its bytes', () => {
+    const scene = test22.makeScene(3, 4);
+    assert.equal(test22.sumVisible(scene), 2 * (0 + 1 + 2 + 3) + 4 * 2);
+    assert.deepEqual(test22.echo(scene), scene);
+
+    const bytes = test22.sceneCodec.encode(scene);
+    assert.ok(bytes instanceof Uint8Array);
+    assert.deepEqual(test22.sceneCodec.decode(bytes.slice().buffer), scene);
+    assert.equal(test22.sumVisible(bytes), test22.sumVisible(scene));
+
+    assert.throws(() => test22.sumVisible({name: 'x'}), TypeError);
+    scene.layers[0].points[0].x = 'x';
+    assert.equal(test22.sceneCodec.encode(scene), undefined);
+    assert.throws(() => test22.sumVisible(scene), TypeError);
+    assert.throws(() => test22.sumVisible(bytes.subarray(1)), TypeError);
+  });
+});
+
+describe('23_arg_policy', () => {
+  it('StrictArgs checks arguments deeply', () => {
+    const {strict} = test23;
+    assert.equal(strict.add(1, 2), 3);
+    assert.equal(strict.sum([1, 2, 3]), 6);
+    assert.equal(strict.join('a', true), 'a yes');
+    assert.throws(() => strict.add('1', 2), TypeError);
+    assert.throws(() => strict.sum([1, '2']), TypeError);
+    assert.throws(() => strict.join(1, 0), TypeError);
+  });
+
+  it('CoercingArgs coerces primitive arguments', () => {
+    const {coercing} = test23;
+    assert.equal(coercing.add('1', 2), 3);
+    assert.equal(coercing.add(true, null), 1);
+    assert.equal(coercing.join(1, 0), '1 no');
+    assert.equal(coercing.join({toString: () => 'b'}, 'x'), 'b yes');
+    assert.throws(() => coercing.add(Symbol('x'), 1), TypeError);
+    assert.equal(coercing.sum([1, 2]), 3);
+    assert.throws(() => coercing.sum([1, '2']), TypeError);
+    assert.throws(() => coercing.add(1), TypeError);
+  });
+
+  it('TrustedArgs checks only JS types', () => {
+    const {trusted} = test23;
+    assert.equal(trusted.add(1, 2), 3);
+    assert.equal(trusted.sum([1, 2, 3]), 6);
+    assert.equal(trusted.join('a', false), 'a no');
+    assert.throws(() => trusted.add('1', 2), TypeError);
+    assert.throws(() => trusted.sum(1), TypeError);
+    assert.throws(() => trusted.join('a'), TypeError);
+  });
+
+  it('TrustedArgs views only buffers of the element type', () => {
+    for (const {length} of [test23.strict, test23.trusted]) {
+      assert.equal(length(new Float32Array(3)), 3);
+      assert.throws(() => length(new ArrayBuffer(8)), TypeError);
+      assert.throws(() => length(new Uint8Array(4)), TypeError);
+      assert.throws(() => length(new Float64Array(2)), TypeError);
+    }
+  });
+
+  it('TrustedArgs views only buffers as Span<uint8_t>', () => {
+    for (const {byteLength} of [test23.strict, test23.trusted]) {
+      assert.equal(byteLength(new SharedArrayBuffer(5)), 5);
+      assert.equal(byteLength(new ArrayBuffer(3)), 3);
+      assert.throws(() => byteLength({}), TypeError);
+      assert.throws(() => byteLength(new Float32Array(1)), TypeError);
+    }
+  });
+});
+
+describe('24_object_pool', () => {
+  function particleStats() {
+    return test24.stats().find(
+        (stats) => stats.blockSize == test24.particleBlockSize);
+  }
+
+  it('Pooled objects are allocated from ObjectPool', async () => {
+    const before = particleStats() || {inUse: 0, allocated: 0};
+    (() => {
+      for (let i = 0; i < 100; ++i) {
+        const particle = new test24.Particle(i, 1);
+        particle.step();
+        assert.equal(particle.x, i + 1);
+        assert.equal(new test24.HandWrittenParticle(i, 1).x(), i);
+      }
+    })();
+    const allocated = particleStats();
+    assert.equal(allocated.allocated - before.allocated, 200);
+    assert.ok(allocated.inUse - before.inUse <= 200);
+
+    await collectGarbage();
+    const freed = particleStats();
+    assert.equal(freed.inUse, before.inUse);
+    assert.equal(freed.reserved, freed.inUse + freed.cached + freed.shared);
+  });
+
+  it('Freed blocks are reused', async () => {
+    await collectGarbage();
+    const before = particleStats();
+    (() => {
+      for (let i = 0; i < 100; ++i) new test24.Particle(i, 1);
+    })();
+    await collectGarbage();
+    const after = particleStats();
+    assert.equal(after.reserved, before.reserved);
+    assert.equal(after.inUse, before.inUse);
+  });
+});
+
+describe('25_expected', () => {
+  it('Expected<T> throws its failure', () => {
+    assert.equal(test25.parse('12'), 12);
+    assert.throws(() => test25.parse('x'), (e) => {
+      return e instanceof Error && e.code == 'EINVAL' &&
+          e.message == 'Not an integer';
+    });
+    assert.equal(test25.check(1), undefined);
+    assert.throws(() => test25.check(-1), /Value is negative/);
+    assert.throws(() => test25.parse(1), TypeError);
+  });
+
+  it('Result<T> returns its failure', () => {
+    assert.equal(test25.tryParse('12'), 12);
+    assert.equal(test25.lookup('a'), 'apple');
+    const error = test25.tryParse('x');
+    assert.ok(error instanceof Error);
+    assert.equal(error.code, 'EINVAL');
+    assert.equal(error.message, 'Not an integer');
+    assert.equal(test25.tryParse('y'), error);
+    assert.equal(test25.rawTryParse('y'), error);
+    assert.equal(test25.rawTryParse('3'), 3);
+    assert.equal(test25.lookup('z').code, 'ENOTFOUND');
+  });
+});
+
+describe('26_array_buffer_fields', () => {
+  const {Particle} = test26;
+
+  it('Fields are accessed by JS through a DataView', () => {
+    const getter = (name) =>
+      Object.getOwnPropertyDescriptor(Particle.prototype, name).get;
+    assert.ok(getter('x').toString().includes('getFloat64'));
+    assert.ok(getter('alive').toString().includes('getUint8'));
+    assert.ok(getter('stamp').toString().includes('[native code]'));
+
+    const particle = new Particle(1, 2);
+    assert.equal(particle.x, 1);
+    assert.equal(particle.y, 2);
+    assert.equal(particle.id, 0);
+    assert.equal(particle.alive, true);
+    assert.deepEqual(Object.keys(particle), []);
+    assert.equal(new Particle().x, 0);
+  });
+
+  it('Methods share memory with JS accessors', () => {
+    const particle = new Particle(1, 2);
+    particle.x = 5;
+    assert.equal(particle.sum(), 7);
+    particle.step(0.5);
+    assert.equal(particle.x, 5.5);
+    assert.equal(particle.y, 2.5);
+    particle.alive = false;
+    assert.equal(particle.alive, false);
+    particle.stamp = 3;
+    assert.equal(particle.stamp, 3);
+
+    const mirrored = test26.mirror(particle);
+    assert.ok(mirrored instanceof Particle);
+    assert.equal(mirrored.x, 2.5);
+    assert.equal(mirrored.y, 5.5);
+    assert.equal(mirrored.alive, false);
+    assert.equal(mirrored.stamp, 3);
+  });
+
+  it('Setters check types', () => {
+    const particle = new Particle(1, 2);
+    assert.throws(() => particle.x = 'a', TypeError);
+    assert.throws(() => particle.alive = 1, TypeError);
+    assert.throws(() => {
+      'use strict';
+      particle.id = 1;
+    }, TypeError);
+    assert.throws(() => new Particle(1), TypeError);
+    assert.throws(() => Particle.prototype.sum.call({}), TypeError);
+  });
+
+  it('The buffer of an object is out of reach of JS', () => {
+    const particle = new Particle(1, 2);
+    assert.deepEqual(Reflect.ownKeys(particle), []);
+    assert.throws(() => new Particle(test26.newExternal()), TypeError);
+    particle.x = 3;
+    assert.equal(particle.sum(), 5);
+  });
+});
+
+describe('27_command_buffer', () => {
+  const {Calculator, Counter} = test27;
+
+  it('Recorded commands run on flush', () => {
+    const calculators = [...Array(100)].map(() => new Calculator());
+    // Small enough to grow while recording.
+    const commands = new Calculator.CommandBuffer(16);
+    for (const calculator of calculators) {
+      commands.increment(calculator, 3);
+      commands.scale(calculator, 2);
+      commands.decrement(calculator);
+    }
+    assert.equal(commands.byteLength, 100 * (12 + 16 + 8));
+    assert.equal(calculators[0].result(), 0);
+    commands.flush();
+    assert.equal(commands.byteLength, 0);
+    for (const calculator of calculators) {
+      assert.equal(calculator.result(), 5);
+    }
+
+    const [calculator] = calculators;
+    commands.setLocked(calculator, true);
+    commands.increment(calculator, 1);
+    commands.setLocked(calculator, false);
+    commands.increment(calculator, -2);
+    commands.flush();
+    assert.equal(calculator.result(), 3);
+    commands.clear(calculator);
+    commands.flush();
+    assert.equal(calculator.result(), 0);
+  });
+
+  it('Commands are validated before any of them runs', () => {
+    const calculator = new Calculator();
+    const commands = new Calculator.CommandBuffer();
+    assert.throws(() => commands.increment(calculator, '1'), TypeError);
+    assert.throws(() => commands.setLocked(calculator, 1), TypeError);
+    assert.throws(() => commands.increment(new Counter(), 1), TypeError);
+    assert.throws(() => commands.increment({}, 1), TypeError);
+    assert.equal(commands.byteLength, 0);
+
+    // A forged object passes the check of the recorder, but not flush(),
+    // which runs none of the commands then.
+    commands.increment(calculator, 1);
+    commands.increment(Object.create(Calculator.prototype), 1);
+    assert.throws(() => commands.flush(), TypeError);
+    assert.equal(calculator.result(), 0);
+    assert.equal(commands.byteLength, 0);
+
+    // An object of another class with the prototype of Calculator.
+    const fake = Object.setPrototypeOf(new Counter(), Calculator.prototype);
+    commands.increment(calculator, 1);
+    commands.scale(fake, 3);
+    assert.throws(() => commands.flush(), TypeError);
+    assert.equal(calculator.result(), 0);
+
+    const counter = new Counter();
+    const counterCommands = new Counter.CommandBuffer();
+    counterCommands.increment(counter);
+    counterCommands.flush();
+    assert.throws(() => test27.defineReserved(), /reserved/);
   });
 });